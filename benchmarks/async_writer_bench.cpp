@@ -0,0 +1,97 @@
+// Measures how long a chatty producer is stalled by a slow reader. Standard output is redirected to
+// a pipe drained by a thread that sleeps between reads, standing in for an SSH pty; the producer
+// prints and flushes one line at a time through Console with and without the async writer.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+#include "opentui/console.hpp"
+
+namespace {
+
+constexpr int kLines = 20000;
+constexpr std::size_t kReadChunk = 4096;
+constexpr auto kReaderDelay = std::chrono::milliseconds(2);
+
+struct SlowReader {
+  explicit SlowReader(const int read_fd)
+      : thread([read_fd]() {
+          char sink[kReadChunk];
+          while (read(read_fd, sink, sizeof(sink)) > 0) {
+            std::this_thread::sleep_for(kReaderDelay);
+          }
+        }) {}
+
+  std::thread thread;
+};
+
+void report(FILE* out, const char* label, const std::optional<opentui::AsyncWriterOptions>& async) {
+  opentui::Console console;
+  if (async.has_value()) {
+    console.enable_async_writer(*async);
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int line = 0; line < kLines; ++line) {
+    console.println("handler output line " + std::to_string(line) +
+                    " ........................................");
+    console.flush();
+  }
+  const auto produced = std::chrono::steady_clock::now();
+
+  opentui::AsyncWriterStats stats;
+  if (const opentui::AsyncWriter* writer = console.async_writer(); writer != nullptr) {
+    stats = writer->stats();
+  }
+  console.disable_async_writer();
+  const auto drained = std::chrono::steady_clock::now();
+
+  const auto milliseconds = [](const auto duration) {
+    return static_cast<long long>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+  };
+  std::fprintf(out, "%-12s producer_ms=%lld drained_ms=%lld dropped_buffers=%llu waits=%llu\n",
+               label, milliseconds(produced - start), milliseconds(drained - start),
+               static_cast<unsigned long long>(stats.buffers_dropped),
+               static_cast<unsigned long long>(stats.producer_waits));
+}
+
+} // namespace
+
+int main() {
+  int pipe_fds[2] = {-1, -1};
+  if (pipe(pipe_fds) != 0) {
+    std::perror("pipe");
+    return 1;
+  }
+
+  const int report_fd = dup(STDOUT_FILENO);
+  FILE* out = fdopen(report_fd, "w");
+  if (out == nullptr || dup2(pipe_fds[1], STDOUT_FILENO) < 0) {
+    std::perror("redirect stdout");
+    return 1;
+  }
+  close(pipe_fds[1]);
+
+  SlowReader reader(pipe_fds[0]);
+
+  report(out, "sync", std::nullopt);
+  report(out, "block", opentui::AsyncWriterOptions{.policy = opentui::BackpressurePolicy::Block});
+  report(out, "drop-oldest",
+         opentui::AsyncWriterOptions{.max_queued_bytes = 64U * 1024U,
+                                     .policy = opentui::BackpressurePolicy::DropOldest});
+  report(out, "summarize",
+         opentui::AsyncWriterOptions{.max_queued_bytes = 64U * 1024U,
+                                     .policy = opentui::BackpressurePolicy::Summarize});
+
+  close(STDOUT_FILENO);
+  reader.thread.join();
+  std::fclose(out);
+  return 0;
+}
@@ -0,0 +1,108 @@
+// Measures batch throughput in commands per second. Half a million generated command lines, some
+// quoted or escaped, are run through CommandRegistry::run_script() and through the line-at-a-time
+// path (std::getline, then execute_line() with a fresh tokenizer per line). Handlers only count
+// their arguments, so the figures are the cost of reading, tokenizing and dispatching. Exits
+// non-zero if the two paths disagree or run_script() is slower.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "opentui/command_registry.hpp"
+#include "opentui/console.hpp"
+
+namespace {
+
+constexpr std::size_t kLines = 500'000;
+constexpr std::size_t kRegisteredCommands = 200;
+
+[[nodiscard]] std::string make_script(std::mt19937& random) {
+  std::string script;
+  for (std::size_t line = 0; line < kLines; ++line) {
+    switch (random() % 4U) {
+    case 0:
+      script += "set key_" + std::to_string(random() % 1000U) + " " +
+                std::to_string(random() % 100000U);
+      break;
+    case 1:
+      script += "/tag \"release candidate\" build\\ " + std::to_string(random() % 100U);
+      break;
+    case 2:
+      script += "plugin_" + std::to_string(random() % kRegisteredCommands) + " --verbose";
+      break;
+    default:
+      script += "noop";
+      break;
+    }
+    script += '\n';
+  }
+  return script;
+}
+
+[[nodiscard]] double seconds_since(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+  std::size_t arguments_seen = 0;
+  const auto count_arguments = [&arguments_seen](const opentui::ArgsView args,
+                                                 opentui::CommandContext& context) {
+    static_cast<void>(context);
+    arguments_seen += args.size();
+  };
+
+  opentui::CommandRegistry registry;
+  bool registered = registry.add({.name = "set", .handler = count_arguments}) &&
+                    registry.add({.name = "/tag", .handler = count_arguments}) &&
+                    registry.add({.name = "noop", .handler = count_arguments});
+  for (std::size_t plugin = 0; plugin < kRegisteredCommands; ++plugin) {
+    registered = registered && registry.add({
+                                   .name = "plugin_" + std::to_string(plugin),
+                                   .handler = count_arguments,
+                               });
+  }
+  if (!registered) {
+    std::puts("FAIL: could not register commands");
+    return 1;
+  }
+
+  std::mt19937 random(5);
+  const std::string script = make_script(random);
+
+  opentui::Console console;
+  std::atomic_bool running{true};
+  opentui::CommandContext context{.console = console, .running = running};
+
+  std::istringstream script_input(script);
+  const auto script_start = std::chrono::steady_clock::now();
+  const opentui::ScriptResult result = registry.run_script(script_input, context);
+  const double script_seconds = seconds_since(script_start);
+  const std::size_t script_arguments = arguments_seen;
+
+  arguments_seen = 0;
+  std::size_t line_commands = 0;
+  std::istringstream line_input(script);
+  const auto line_start = std::chrono::steady_clock::now();
+  for (std::string line; std::getline(line_input, line);) {
+    static_cast<void>(registry.execute_line(line, context));
+    ++line_commands;
+  }
+  const double line_seconds = seconds_since(line_start);
+
+  std::printf("commands=%zu script_per_s=%.0f line_per_s=%.0f speedup=%.2fx\n", result.commands,
+              static_cast<double>(result.commands) / script_seconds,
+              static_cast<double>(line_commands) / line_seconds, line_seconds / script_seconds);
+
+  if (result.commands != line_commands || result.failed != 0U ||
+      script_arguments != arguments_seen) {
+    std::puts("FAIL: run_script and execute_line disagree");
+    return 1;
+  }
+  return script_seconds <= line_seconds ? 0 : 1;
+}
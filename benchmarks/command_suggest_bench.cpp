@@ -0,0 +1,123 @@
+// Measures "did you mean" lookups over registries of plugin-style command names. Each query is a
+// registered name with one or two random typos, looked up through BkTree and through a linear scan
+// with the same early-exit edit_distance(). Exits non-zero if the two disagree or the tree is
+// slower at the largest size.
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/bk_tree.hpp"
+
+namespace {
+
+constexpr std::size_t kSizes[] = {1'000, 10'000, 50'000};
+constexpr std::size_t kQueries = 500;
+constexpr std::size_t kMaxDistance = 2;
+
+constexpr std::string_view kPlugins[] = {
+    "git",   "docker", "kube",  "aws",    "gcloud", "npm",    "cargo", "pip",
+    "brew",  "helm",   "terra", "vault",  "consul", "nomad",  "redis", "pg",
+    "mysql", "kafka",  "spark", "presto", "trino",  "airflow",
+};
+constexpr std::string_view kVerbs[] = {
+    "status", "start",  "stop",   "restart", "deploy",  "rollback", "logs",   "describe",
+    "list",   "create", "delete", "apply",   "inspect", "attach",   "exec",   "scale",
+    "sync",   "diff",   "push",   "pull",    "build",   "publish",  "verify", "prune",
+};
+
+[[nodiscard]] std::string make_name(std::mt19937& random, const std::size_t serial) {
+  std::string name{kPlugins[random() % std::size(kPlugins)]};
+  name += '-';
+  name += kVerbs[random() % std::size(kVerbs)];
+  name += std::to_string(serial);
+  return name;
+}
+
+[[nodiscard]] std::string with_typos(std::mt19937& random, std::string word) {
+  const std::size_t typos = 1U + random() % kMaxDistance;
+  for (std::size_t typo = 0; typo < typos && !word.empty(); ++typo) {
+    const std::size_t position = random() % word.size();
+    const auto letter = static_cast<char>('a' + random() % 26U);
+    switch (random() % 3U) {
+    case 0:
+      word[position] = letter;
+      break;
+    case 1:
+      word.insert(word.begin() + static_cast<std::ptrdiff_t>(position), letter);
+      break;
+    default:
+      word.erase(position, 1);
+      break;
+    }
+  }
+  return word;
+}
+
+[[nodiscard]] double microseconds_since(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main() {
+  bool agree = true;
+  double tree_per_query = 0.0;
+  double scan_per_query = 0.0;
+
+  for (const std::size_t size : kSizes) {
+    std::mt19937 random(11);
+    std::vector<std::string> names;
+    names.reserve(size);
+    for (std::size_t serial = 0; serial < size; ++serial) {
+      names.push_back(make_name(random, serial));
+    }
+
+    opentui::BkTree tree;
+    const auto build_start = std::chrono::steady_clock::now();
+    for (const std::string& name : names) {
+      tree.add(name, name);
+    }
+    const double build_us = microseconds_since(build_start);
+
+    std::vector<std::string> queries;
+    queries.reserve(kQueries);
+    for (std::size_t query = 0; query < kQueries; ++query) {
+      queries.push_back(with_typos(random, names[random() % names.size()]));
+    }
+
+    std::vector<opentui::BkMatch> matches;
+    std::size_t tree_matches = 0;
+    const auto tree_start = std::chrono::steady_clock::now();
+    for (const std::string& query : queries) {
+      tree.find_within(query, kMaxDistance, matches);
+      tree_matches += matches.size();
+    }
+    tree_per_query = microseconds_since(tree_start) / kQueries;
+
+    std::size_t scan_matches = 0;
+    const auto scan_start = std::chrono::steady_clock::now();
+    for (const std::string& query : queries) {
+      for (const std::string& name : names) {
+        if (opentui::edit_distance(query, name, kMaxDistance) <= kMaxDistance) {
+          ++scan_matches;
+        }
+      }
+    }
+    scan_per_query = microseconds_since(scan_start) / kQueries;
+
+    agree = agree && tree_matches == scan_matches;
+    std::printf("names=%-6zu build_ms=%7.2f tree_us=%8.1f scan_us=%9.1f matches=%zu\n", size,
+                build_us / 1000.0, tree_per_query, scan_per_query, tree_matches);
+  }
+
+  if (!agree) {
+    std::puts("FAIL: BkTree and linear scan disagree");
+    return 1;
+  }
+  return tree_per_query <= scan_per_query ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+// Compares the write(2) syscalls issued per keystroke by the legacy std::cout redraw path and the
+// frame-buffered Console path. Output is sent to a pseudo-terminal so stdio buffering behaves as
+// it does in an interactive session; syscall counts come from /proc/self/io where available.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "opentui/console.hpp"
+
+namespace {
+
+constexpr std::string_view kPrompt = "dbg> ";
+constexpr std::string_view kTypedLine = "udp_send 127.0.0.1 9000 hello from the benchmark";
+constexpr std::string_view kSuggestion = "udp_send 127.0.0.1 9000 hello from the benchmark harness";
+constexpr std::string_view kCompletionLine = "completions: udp_send  udp_wait";
+constexpr int kRounds = 200;
+
+[[nodiscard]] std::optional<std::uint64_t> write_syscalls() {
+  std::ifstream io("/proc/self/io");
+  std::string key;
+  std::uint64_t value = 0;
+  while (io >> key >> value) {
+    if (key == "syscw:") {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+void legacy_redraw(std::string_view buffer) {
+  const auto draw_input_line = [&]() {
+    std::cout << '\r' << kPrompt << buffer;
+    const std::string_view suffix = kSuggestion.substr(buffer.size());
+    std::cout << "\033[90m" << suffix << "\033[0m";
+    std::cout << "\033[" << suffix.size() << "D";
+    std::cout << "\033[K";
+  };
+
+  draw_input_line();
+  std::cout << '\n' << kCompletionLine << "\033[K";
+  std::cout << "\033[1A";
+  draw_input_line();
+  std::cout << std::flush;
+}
+
+void buffered_redraw(opentui::Console& console, std::string_view buffer) {
+  const auto draw_input_line = [&]() {
+    console.print("\r");
+    console.print(kPrompt);
+    console.print(buffer);
+    const std::string_view suffix = kSuggestion.substr(buffer.size());
+    console.print("\033[90m");
+    console.print(suffix);
+    console.print("\033[0m\033[");
+    console.print(std::to_string(suffix.size()));
+    console.print("D");
+    console.print("\033[K");
+  };
+
+  draw_input_line();
+  console.print("\n");
+  console.print(kCompletionLine);
+  console.print("\033[K\033[1A");
+  draw_input_line();
+  console.flush();
+}
+
+template <typename Redraw>
+void report(FILE* out, const char* label, const Redraw& redraw) {
+  const auto syscalls_before = write_syscalls();
+  const auto start = std::chrono::steady_clock::now();
+
+  std::size_t keystrokes = 0;
+  for (int round = 0; round < kRounds; ++round) {
+    for (std::size_t length = 1; length <= kTypedLine.size(); ++length) {
+      redraw(kTypedLine.substr(0, length));
+      ++keystrokes;
+    }
+  }
+
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  const auto syscalls_after = write_syscalls();
+  const double nanoseconds_per_key =
+      static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+      static_cast<double>(keystrokes);
+
+  if (syscalls_before.has_value() && syscalls_after.has_value()) {
+    std::fprintf(out, "%-10s keystrokes=%zu write_syscalls/key=%.2f ns/key=%.0f\n", label,
+                 keystrokes,
+                 static_cast<double>(*syscalls_after - *syscalls_before) /
+                     static_cast<double>(keystrokes),
+                 nanoseconds_per_key);
+  } else {
+    std::fprintf(out, "%-10s keystrokes=%zu write_syscalls/key=n/a ns/key=%.0f\n", label,
+                 keystrokes, nanoseconds_per_key);
+  }
+}
+
+} // namespace
+
+int main() {
+  const int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+    std::perror("posix_openpt");
+    return 1;
+  }
+
+  const int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+  if (slave < 0) {
+    std::perror("open pty slave");
+    return 1;
+  }
+
+  std::thread drain([master]() {
+    char sink[4096];
+    while (read(master, sink, sizeof(sink)) > 0) {
+    }
+  });
+  drain.detach();
+
+  const int report_fd = dup(STDOUT_FILENO);
+  FILE* out = fdopen(report_fd, "w");
+  if (out == nullptr || dup2(slave, STDOUT_FILENO) < 0) {
+    std::perror("redirect stdout");
+    return 1;
+  }
+
+  report(out, "legacy", [](std::string_view buffer) { legacy_redraw(buffer); });
+
+  opentui::Console console;
+  report(out, "buffered",
+         [&console](std::string_view buffer) { buffered_redraw(console, buffer); });
+
+  const opentui::OutputStats& stats = console.output_stats();
+  std::fprintf(out, "buffered   console write_calls=%llu bytes=%llu flushes=%llu\n",
+               static_cast<unsigned long long>(stats.write_calls),
+               static_cast<unsigned long long>(stats.bytes_written),
+               static_cast<unsigned long long>(stats.flushes));
+  std::fclose(out);
+  return 0;
+}
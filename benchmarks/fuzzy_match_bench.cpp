@@ -0,0 +1,112 @@
+// Measures fuzzy completion over half a million path-like candidates. Each query is typed one
+// character at a time, and every prefix is searched through FuzzyIndex (mask prefilter plus
+// top-K, and the match count a completion page reports) and through fuzzy_filter(), which scores
+// and sorts every candidate. Exits non-zero if the two disagree on the best matches or their
+// number, or the index is slower.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/fuzzy_matcher.hpp"
+
+namespace {
+
+constexpr std::size_t kCandidates = 500'000;
+constexpr std::size_t kTopK = 50;
+// One frame at 60 Hz.
+constexpr double kFrameBudgetMilliseconds = 1000.0 / 60.0;
+
+constexpr std::string_view kSegments[] = {
+    "src",     "include", "tests",  "docs",   "build",   "scripts", "stabilize", "ci",
+    "render",  "buffer",  "socket", "worker", "history", "prompt",  "config",    "cache",
+    "release", "module",  "parser", "layout", "theme",   "session", "network",   "driver",
+};
+constexpr std::string_view kExtensions[] = {".cpp", ".hpp", ".md", ".json", ".py", ".txt"};
+constexpr std::string_view kQueries[] = {"stc", "srcbuf", "rendlay", "zzq", "cfgcache.h"};
+
+[[nodiscard]] std::string make_candidate(std::mt19937& random) {
+  std::string candidate;
+  const std::size_t depth = 2U + random() % 4U;
+  for (std::size_t level = 0; level < depth; ++level) {
+    if (level != 0U) {
+      candidate += '/';
+    }
+    candidate += kSegments[random() % std::size(kSegments)];
+    if (random() % 3U == 0U) {
+      candidate += '-';
+      candidate += kSegments[random() % std::size(kSegments)];
+    }
+  }
+  candidate += std::to_string(random() % 1000U);
+  candidate += kExtensions[random() % std::size(kExtensions)];
+  return candidate;
+}
+
+[[nodiscard]] double milliseconds_since(const std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 random(7);
+  std::vector<std::string> candidates;
+  candidates.reserve(kCandidates);
+  for (std::size_t index = 0; index < kCandidates; ++index) {
+    candidates.push_back(make_candidate(random));
+  }
+
+  const auto build_start = std::chrono::steady_clock::now();
+  const opentui::FuzzyIndex index(candidates);
+  std::printf("candidates=%zu index_build_ms=%.1f top_k=%zu\n", kCandidates,
+              milliseconds_since(build_start), kTopK);
+
+  double index_total = 0.0;
+  double index_worst = 0.0;
+  double filter_total = 0.0;
+  bool agree = true;
+
+  for (const std::string_view query : kQueries) {
+    for (std::size_t length = 1; length <= query.size(); ++length) {
+      const std::string_view pattern = query.substr(0, length);
+
+      const auto index_start = std::chrono::steady_clock::now();
+      std::size_t matching = 0;
+      const std::vector<opentui::FuzzyMatch> top = index.search(pattern, kTopK, &matching);
+      const double index_ms = milliseconds_since(index_start);
+
+      const auto filter_start = std::chrono::steady_clock::now();
+      const std::vector<std::string> ranked = opentui::fuzzy_filter(pattern, candidates);
+      const double filter_ms = milliseconds_since(filter_start);
+
+      const std::size_t compared = std::min(top.size(), ranked.size());
+      agree = agree && matching == ranked.size() && top.size() == std::min(kTopK, ranked.size());
+      for (std::size_t rank = 0; rank < compared; ++rank) {
+        agree = agree && index[top[rank].index] == ranked[rank];
+      }
+
+      std::printf("%-12.*s matches=%-7zu index_ms=%6.2f filter_ms=%7.2f best=%s\n",
+                  static_cast<int>(pattern.size()), pattern.data(), ranked.size(), index_ms,
+                  filter_ms, top.empty() ? "-" : std::string{index[top.front().index]}.c_str());
+      index_total += index_ms;
+      index_worst = std::max(index_worst, index_ms);
+      filter_total += filter_ms;
+    }
+  }
+
+  std::printf("index_total_ms=%.1f index_worst_ms=%.2f filter_total_ms=%.1f within_frame=%s\n",
+              index_total, index_worst, filter_total,
+              index_worst <= kFrameBudgetMilliseconds ? "yes" : "no");
+
+  if (!agree) {
+    std::puts("FAIL: FuzzyIndex and fuzzy_filter disagree");
+    return 1;
+  }
+  return index_total <= filter_total ? 0 : 1;
+}
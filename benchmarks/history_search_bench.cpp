@@ -0,0 +1,155 @@
+// Measures history lookups at a million entries. Every prefix of a sampled entry is looked up the
+// way autosuggestion does on each keystroke, and every substring typed into reverse-i-search is
+// searched incrementally; both are timed through History's index and through the plain backwards
+// scan it replaced. Exits non-zero if the index is slower on average than the scan.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/history.hpp"
+
+namespace {
+
+constexpr std::size_t kCapacity = 1'000'000;
+// Overfilling the ring makes the index handle evictions as well.
+constexpr std::size_t kEntries = kCapacity + kCapacity / 4U;
+constexpr std::size_t kSamples = 200;
+
+constexpr std::string_view kWords[] = {
+    "attach", "status", "config", "model",  "deploy", "build", "release", "verbose",
+    "cache",  "worker", "socket", "buffer", "render", "prompt", "history", "session",
+};
+
+[[nodiscard]] std::string make_entry(std::mt19937& random) {
+  std::string entry = "/";
+  entry += kWords[random() % std::size(kWords)];
+  const std::size_t arguments = 1U + random() % 3U;
+  for (std::size_t index = 0; index < arguments; ++index) {
+    entry += ' ';
+    entry += kWords[random() % std::size(kWords)];
+    entry += '-';
+    entry += std::to_string(random() % 100000U);
+  }
+  return entry;
+}
+
+[[nodiscard]] std::optional<std::size_t> scan_extending(const opentui::History& history,
+                                                        std::string_view prefix) {
+  for (std::size_t index = history.size(); index-- > 0U;) {
+    const std::string_view entry = history[index];
+    if (entry.size() > prefix.size() && entry.starts_with(prefix)) {
+      return index;
+    }
+  }
+  return std::nullopt;
+}
+
+[[nodiscard]] std::optional<std::size_t> scan_containing(const opentui::History& history,
+                                                         std::string_view pattern,
+                                                         const std::size_t before) {
+  for (std::size_t index = before; index-- > 0U;) {
+    if (history[index].find(pattern) != std::string_view::npos) {
+      return index;
+    }
+  }
+  return std::nullopt;
+}
+
+struct Timing {
+  double total_microseconds{0.0};
+  double max_microseconds{0.0};
+  std::size_t queries{0};
+
+  template <typename Query> void measure(const Query& query) {
+    const auto start = std::chrono::steady_clock::now();
+    query();
+    const double elapsed =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    total_microseconds += elapsed;
+    max_microseconds = std::max(max_microseconds, elapsed);
+    ++queries;
+  }
+
+  [[nodiscard]] double mean() const {
+    return queries == 0U ? 0.0 : total_microseconds / static_cast<double>(queries);
+  }
+};
+
+void report(const char* label, const Timing& timing) {
+  std::printf("%-20s queries=%zu mean_us=%.2f max_us=%.2f\n", label, timing.queries,
+              timing.mean(), timing.max_microseconds);
+}
+
+} // namespace
+
+int main() {
+  std::mt19937 random(2024);
+  opentui::History history(kCapacity);
+
+  const auto fill_start = std::chrono::steady_clock::now();
+  for (std::size_t index = 0; index < kEntries; ++index) {
+    history.add(make_entry(random));
+  }
+  const double fill_seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - fill_start).count();
+  std::printf("entries=%zu fill_s=%.2f\n", history.size(), fill_seconds);
+
+  std::vector<std::string> samples;
+  for (std::size_t index = 0; index < kSamples; ++index) {
+    samples.emplace_back(history[random() % history.size()]);
+  }
+
+  Timing indexed_prefix;
+  Timing scanned_prefix;
+  Timing indexed_search;
+  Timing scanned_search;
+  bool agree = true;
+
+  for (const std::string& sample : samples) {
+    for (std::size_t length = 1; length < sample.size(); ++length) {
+      const std::string_view prefix = std::string_view{sample}.substr(0, length);
+      std::optional<std::size_t> indexed;
+      std::optional<std::size_t> scanned;
+      indexed_prefix.measure([&]() { indexed = history.newest_extending(prefix); });
+      scanned_prefix.measure([&]() { scanned = scan_extending(history, prefix); });
+      agree = agree && indexed == scanned;
+    }
+
+    // Type the sample's last argument into reverse-i-search one character at a time.
+    const std::string_view typed = std::string_view{sample}.substr(sample.rfind(' ') + 1U);
+    std::size_t before = history.size();
+    for (std::size_t length = 1; length <= typed.size(); ++length) {
+      const std::string_view pattern = typed.substr(0, length);
+      std::optional<std::size_t> indexed;
+      std::optional<std::size_t> scanned;
+      indexed_search.measure([&]() { indexed = history.search_backward(pattern, before); });
+      scanned_search.measure([&]() { scanned = scan_containing(history, pattern, before); });
+      agree = agree && indexed == scanned;
+      if (indexed.has_value()) {
+        before = *indexed + 1U;
+      }
+    }
+  }
+
+  report("prefix/indexed", indexed_prefix);
+  report("prefix/scan", scanned_prefix);
+  report("search/indexed", indexed_search);
+  report("search/scan", scanned_search);
+
+  if (!agree) {
+    std::puts("FAIL: indexed results differ from the scan");
+    return 1;
+  }
+  if (indexed_prefix.mean() > scanned_prefix.mean() ||
+      indexed_search.mean() > scanned_search.mean()) {
+    std::puts("FAIL: indexed lookups are slower than the scan");
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,104 @@
+// Measures editing in the middle of a very long line, as after pasting a large prompt: characters
+// are inserted one at a time halfway through the line and then deleted again, and the line is
+// redrawn through InputRenderer, on an 80-column row, after every key. Compares GapBuffer, drawn
+// from both sides of its gap, with inserting into a std::string, and exits non-zero if the gap
+// buffer is slower. Frames are written to /dev/null.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "opentui/console.hpp"
+#include "opentui/gap_buffer.hpp"
+#include "opentui/input_renderer.hpp"
+
+namespace {
+
+constexpr std::string_view kPrompt = "> ";
+constexpr std::size_t kLineBytes = 256 * 1024;
+constexpr std::size_t kEdits = 5000;
+constexpr std::size_t kColumns = 80;
+
+template <typename Edit> [[nodiscard]] double time_per_edit_ns(const Edit& edit) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t index = 0; index < kEdits; ++index) {
+    edit();
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start)
+             .count() /
+         static_cast<double>(kEdits);
+}
+
+} // namespace
+
+int main() {
+  const int report_fd = dup(STDOUT_FILENO);
+  FILE* out = fdopen(report_fd, "w");
+  const int null_fd = open("/dev/null", O_WRONLY);
+  if (out == nullptr || null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0) {
+    std::perror("redirect stdout");
+    return 1;
+  }
+
+  const std::string line(kLineBytes, 'x');
+  opentui::Console console;
+  opentui::InputRenderer renderer(console);
+  renderer.set_columns(kColumns);
+
+  std::string plain = line;
+  std::size_t plain_cursor = plain.size() / 2U;
+  const auto redraw_plain = [&]() {
+    renderer.render(
+        opentui::InputFrame{.prompt = kPrompt, .buffer = plain, .cursor = plain_cursor});
+  };
+  redraw_plain();
+  const double string_insert = time_per_edit_ns([&]() {
+    plain.insert(plain_cursor++, 1U, 'a');
+    redraw_plain();
+  });
+  const double string_erase = time_per_edit_ns([&]() {
+    plain.erase(--plain_cursor, 1U);
+    redraw_plain();
+  });
+
+  opentui::GapBuffer gap;
+  gap.assign(line);
+  for (std::size_t index = 0; index < kLineBytes / 2U; ++index) {
+    static_cast<void>(gap.move_left());
+  }
+  const auto redraw_gap = [&]() {
+    renderer.render(opentui::InputFrame{.prompt = kPrompt,
+                                        .buffer = gap.before_gap(),
+                                        .buffer_tail = gap.after_gap(),
+                                        .cursor = gap.cursor()});
+  };
+  renderer.invalidate();
+  redraw_gap();
+  const double gap_insert = time_per_edit_ns([&]() {
+    gap.insert("a");
+    redraw_gap();
+  });
+  const double gap_erase = time_per_edit_ns([&]() {
+    static_cast<void>(gap.erase_before());
+    redraw_gap();
+  });
+  renderer.clear();
+  console.flush();
+
+  std::fprintf(out, "line_bytes=%zu edits=%zu columns=%zu redraw=every key\n", kLineBytes,
+               kEdits, kColumns);
+  std::fprintf(out, "%-12s insert_ns=%.1f erase_ns=%.1f\n", "std::string", string_insert,
+               string_erase);
+  std::fprintf(out, "%-12s insert_ns=%.1f erase_ns=%.1f\n", "GapBuffer", gap_insert, gap_erase);
+
+  const bool identical = gap.text() == plain;
+  if (!identical) {
+    std::fputs("FAIL: buffers differ\n", out);
+  }
+  std::fclose(out);
+  return identical && gap_insert <= string_insert && gap_erase <= string_erase ? 0 : 1;
+}
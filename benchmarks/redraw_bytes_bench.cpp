@@ -0,0 +1,122 @@
+// Replays a scripted editing session through the previous double-paint redraw and through
+// InputRenderer, reporting the bytes sent to the terminal per keystroke. Frames are written to
+// /dev/null; the numbers are meant to catch regressions in the amount of output per keystroke.
+
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "opentui/console.hpp"
+#include "opentui/input_renderer.hpp"
+
+namespace {
+
+constexpr std::string_view kPrompt = "dbg> ";
+constexpr std::string_view kTypedLine = "udp_send 127.0.0.1 9000 hello from the benchmark";
+constexpr std::string_view kSuggestion = "udp_send 127.0.0.1 9000 hello from the benchmark harness";
+
+struct Keystroke {
+  std::string buffer;
+  std::string completion_line;
+};
+
+// Types the line, deletes half of it again and retypes it. The completion row only changes while
+// the command word is being typed, as it does with the debugger example's completions.
+[[nodiscard]] std::vector<Keystroke> scripted_session() {
+  std::vector<Keystroke> session;
+  const auto completion_for = [](const std::size_t length) {
+    return length <= 4U ? std::string{"completions: udp_send  udp_wait"}
+                        : std::string{"completions: udp_send"};
+  };
+
+  for (std::size_t length = 1; length <= kTypedLine.size(); ++length) {
+    session.push_back({std::string{kTypedLine.substr(0, length)}, completion_for(length)});
+  }
+  for (std::size_t length = kTypedLine.size(); length-- > kTypedLine.size() / 2U;) {
+    session.push_back({std::string{kTypedLine.substr(0, length)}, completion_for(length)});
+  }
+  for (std::size_t length = kTypedLine.size() / 2U + 1U; length <= kTypedLine.size(); ++length) {
+    session.push_back({std::string{kTypedLine.substr(0, length)}, completion_for(length)});
+  }
+  return session;
+}
+
+[[nodiscard]] std::size_t legacy_frame_bytes(const Keystroke& keystroke) {
+  std::string frame;
+  const auto draw_input_line = [&]() {
+    frame += '\r';
+    frame += kPrompt;
+    frame += keystroke.buffer;
+    const std::string_view suffix = kSuggestion.substr(keystroke.buffer.size());
+    frame += "\033[90m";
+    frame += suffix;
+    frame += "\033[0m\033[";
+    frame += std::to_string(suffix.size());
+    frame += "D\033[K";
+  };
+
+  draw_input_line();
+  frame += '\n';
+  frame += keystroke.completion_line;
+  frame += "\033[K\033[1A";
+  draw_input_line();
+  return frame.size();
+}
+
+[[nodiscard]] std::uint64_t renderer_bytes(opentui::Console& console,
+                                           const std::vector<Keystroke>& session,
+                                           const bool synchronized_output) {
+  opentui::InputRenderer renderer(console);
+  renderer.set_synchronized_output(synchronized_output);
+
+  const std::uint64_t before = console.output_stats().bytes_written;
+  for (const Keystroke& keystroke : session) {
+    const std::span completion_rows{&keystroke.completion_line, 1U};
+    renderer.render(opentui::InputFrame{.prompt = kPrompt,
+                                        .buffer = keystroke.buffer,
+                                        .autosuggestion = kSuggestion,
+                                        .completion_rows = completion_rows});
+  }
+  renderer.clear();
+  console.flush();
+  return console.output_stats().bytes_written - before;
+}
+
+} // namespace
+
+int main() {
+  const int report_fd = dup(STDOUT_FILENO);
+  FILE* out = fdopen(report_fd, "w");
+  const int null_fd = open("/dev/null", O_WRONLY);
+  if (out == nullptr || null_fd < 0 || dup2(null_fd, STDOUT_FILENO) < 0) {
+    std::perror("redirect stdout");
+    return 1;
+  }
+
+  const std::vector<Keystroke> session = scripted_session();
+  const auto keystrokes = static_cast<double>(session.size());
+
+  std::uint64_t legacy = 0;
+  for (const Keystroke& keystroke : session) {
+    legacy += legacy_frame_bytes(keystroke);
+  }
+
+  opentui::Console console;
+  const std::uint64_t renderer = renderer_bytes(console, session, false);
+  const std::uint64_t synchronized = renderer_bytes(console, session, true);
+
+  std::fprintf(out, "keystrokes=%zu\n", session.size());
+  std::fprintf(out, "%-14s bytes/key=%.1f\n", "legacy", static_cast<double>(legacy) / keystrokes);
+  std::fprintf(out, "%-14s bytes/key=%.1f\n", "renderer",
+               static_cast<double>(renderer) / keystrokes);
+  std::fprintf(out, "%-14s bytes/key=%.1f\n", "renderer+sync",
+               static_cast<double>(synchronized) / keystrokes);
+  std::fclose(out);
+  return renderer <= legacy ? 0 : 1;
+}
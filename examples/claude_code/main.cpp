@@ -3,12 +3,17 @@
 #include <cstddef>
 #include <cstdlib>
 #include <filesystem>
+#include <map>
+#include <optional>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <system_error>
 #include <utility>
 #include <vector>
 
+#include "opentui/display_width.hpp"
+#include "opentui/fuzzy_matcher.hpp"
 #include "opentui/tui_application.hpp"
 
 namespace {
@@ -19,24 +24,8 @@ constexpr std::size_t kPanelWidth = 92;
   return "+" + std::string(kPanelWidth - 2U, '-') + "+";
 }
 
-[[nodiscard]] std::string fit_cell(std::string text, const std::size_t width) {
-  if (text.size() > width) {
-    if (width > 3U) {
-      text = text.substr(0, width - 3U) + "...";
-    } else {
-      text = text.substr(0, width);
-    }
-  }
-
-  if (text.size() < width) {
-    text.append(width - text.size(), ' ');
-  }
-
-  return text;
-}
-
 [[nodiscard]] std::string panel_line(const std::string& body) {
-  return "| " + fit_cell(body, kPanelWidth - 4U) + " |";
+  return "| " + opentui::fit_to_width(body, kPanelWidth - 4U) + " |";
 }
 
 [[nodiscard]] std::string join_args(const opentui::Args& args, const std::size_t start_index = 0U) {
@@ -56,91 +45,81 @@ constexpr std::size_t kPanelWidth = 92;
   return std::max(minimum, estimated);
 }
 
+// Completers of fixed lists return all of it; the registry matches it against the partial
+// argument.
 template <std::size_t N>
 [[nodiscard]] std::vector<std::string>
-prefix_filter(const std::string_view partial, const std::array<std::string_view, N>& candidates) {
-  std::vector<std::string> results;
-  for (const std::string_view candidate : candidates) {
-    if (partial.empty() || candidate.starts_with(partial)) {
-      results.emplace_back(candidate);
-    }
-  }
-  return results;
+whole_list(const std::array<std::string_view, N>& candidates) {
+  return std::vector<std::string>(candidates.begin(), candidates.end());
 }
 
-[[nodiscard]] std::vector<std::string> complete_path_argument(const std::string_view partial) {
-  namespace fs = std::filesystem;
+// A path argument split at its last separator: the directory part as typed, the file name being
+// completed, and the directory that part refers to.
+struct PathArgument {
+  std::string display_base;
+  std::string leaf_prefix;
+  std::filesystem::path directory;
+};
 
+[[nodiscard]] std::optional<PathArgument> split_path_argument(const std::string_view partial) {
   std::string input{partial};
   if (input == "~") {
     input = "~/";
   }
 
-  std::string display_base;
-  std::string leaf_prefix;
-
-  const auto split_input = [&](const std::string& text) {
-    if (!text.empty() && (text.back() == '/' || text.back() == '\\')) {
-      display_base = text;
-      leaf_prefix.clear();
-      return;
-    }
-
-    const std::size_t separator_pos = text.find_last_of("/\\");
-    if (separator_pos == std::string::npos) {
-      display_base.clear();
-      leaf_prefix = text;
-      return;
-    }
-
-    display_base = text.substr(0, separator_pos + 1U);
-    leaf_prefix = text.substr(separator_pos + 1U);
-  };
-
-  split_input(input);
+  PathArgument argument;
+  const std::size_t separator_pos = input.find_last_of("/\\");
+  if (separator_pos == std::string::npos) {
+    argument.leaf_prefix = input;
+  } else {
+    argument.display_base = input.substr(0, separator_pos + 1U);
+    argument.leaf_prefix = input.substr(separator_pos + 1U);
+  }
 
-  fs::path resolved_directory{"."};
-  if (display_base.rfind("~/", 0U) == 0U) {
+  argument.directory = ".";
+  if (argument.display_base.starts_with("~/")) {
     const char* home = std::getenv("HOME");
     if (home == nullptr) {
-      return {};
+      return std::nullopt;
     }
-    resolved_directory = fs::path(home) / display_base.substr(2U);
-  } else if (!display_base.empty()) {
-    resolved_directory = fs::path(display_base);
+    argument.directory = std::filesystem::path(home) / argument.display_base.substr(2U);
+  } else if (!argument.display_base.empty()) {
+    argument.directory = argument.display_base;
   }
+  return argument;
+}
+
+// Names in `directory`, sorted, with a '/' after those of directories. Empty if it is not a
+// directory, and nullopt if `stop_token` is signalled before the listing is complete.
+[[nodiscard]] std::optional<std::vector<std::string>>
+list_directory(const std::filesystem::path& directory, const std::stop_token& stop_token) {
+  namespace fs = std::filesystem;
 
+  std::vector<std::string> names;
   std::error_code error;
-  if (!fs::exists(resolved_directory, error) || !fs::is_directory(resolved_directory, error)) {
-    return {};
+  if (!fs::is_directory(directory, error)) {
+    return names;
   }
 
-  std::vector<std::string> suggestions;
-  for (const fs::directory_entry& entry : fs::directory_iterator(
-           resolved_directory, fs::directory_options::skip_permission_denied, error)) {
+  for (const fs::directory_entry& entry :
+       fs::directory_iterator(directory, fs::directory_options::skip_permission_denied, error)) {
+    if (stop_token.stop_requested()) {
+      return std::nullopt;
+    }
     if (error) {
       break;
     }
 
-    const std::string file_name = entry.path().filename().string();
-    if (!leaf_prefix.empty() && !std::string_view{file_name}.starts_with(leaf_prefix)) {
-      continue;
-    }
-
+    std::string name = entry.path().filename().string();
     std::error_code type_error;
-    const bool is_directory = entry.is_directory(type_error);
-
-    std::string suggestion = display_base + file_name;
-    if (!type_error && is_directory) {
-      suggestion.push_back('/');
+    if (entry.is_directory(type_error) && !type_error) {
+      name.push_back('/');
     }
-    suggestions.push_back(std::move(suggestion));
+    names.push_back(std::move(name));
   }
 
-  std::ranges::sort(suggestions);
-  const auto unique_result = std::ranges::unique(suggestions);
-  suggestions.erase(unique_result.begin(), suggestions.end());
-  return suggestions;
+  std::ranges::sort(names);
+  return names;
 }
 
 class ClaudeCodeStyleDemo final : public opentui::TuiApplication {
@@ -153,6 +132,14 @@ protected:
     return "claude> ";
   }
 
+  [[nodiscard]] std::filesystem::path history_file() const override {
+    const char* home = std::getenv("HOME");
+    if (home == nullptr) {
+      return {};
+    }
+    return std::filesystem::path(home) / ".open_tui_claude_history";
+  }
+
   void on_start(opentui::Console& console) override {
     render_shell_chrome(console);
     console.println_color(
@@ -204,14 +191,16 @@ protected:
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
 
               constexpr std::array<std::string_view, 4> model_candidates{
                   "claude-haiku-3.5", "claude-sonnet-4.5", "claude-opus-4", "gpt-5-codex"};
-              return prefix_filter(partial, model_candidates);
+              return whole_list(model_candidates);
             },
+        .narrowable = true,
     });
 
     register_command(opentui::Command{
@@ -244,13 +233,15 @@ protected:
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
 
               constexpr std::array<std::string_view, 3> theme_candidates{"dark", "dusk", "light"};
-              return prefix_filter(partial, theme_candidates);
+              return whole_list(theme_candidates);
             },
+        .narrowable = true,
     });
 
     register_command(opentui::Command{
@@ -274,12 +265,32 @@ protected:
               attached_files_.push_back(path);
               console().println_color("Attached: " + path, opentui::Color::BrightGreen);
             },
-        .completer =
-            [](const std::string_view partial, const opentui::Args& args) {
+        .completer = nullptr,
+        .paged_completer =
+            [this](const std::string_view partial, const opentui::ArgsView args,
+                   const std::size_t offset, const std::size_t count,
+                   std::vector<std::string>& page,
+                   const std::stop_token& stop_token) -> std::size_t {
               if (!args.empty()) {
-                return std::vector<std::string>{};
+                return 0U;
+              }
+              const std::optional<PathArgument> argument = split_path_argument(partial);
+              if (!argument.has_value()) {
+                return 0U;
+              }
+              const opentui::FuzzyIndex* names = attach_listing(argument->directory, stop_token);
+              if (names == nullptr) {
+                return 0U;
               }
-              return complete_path_argument(partial);
+
+              const std::size_t first = std::min(offset, names->size());
+              std::size_t matching = 0;
+              const std::vector<opentui::FuzzyMatch> best = names->search(
+                  argument->leaf_prefix, first + std::min(count, names->size() - first), &matching);
+              for (std::size_t rank = first; rank < best.size(); ++rank) {
+                page.push_back(argument->display_base + std::string{(*names)[best[rank].index]});
+              }
+              return matching;
             },
     });
 
@@ -322,14 +333,16 @@ protected:
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
 
               constexpr std::array<std::string_view, 7> focus_candidates{
                   "code", "tests", "ci", "docs", "performance", "refactor", "release"};
-              return prefix_filter(partial, focus_candidates);
+              return whole_list(focus_candidates);
             },
+        .narrowable = true,
     });
 
     register_command(opentui::Command{
@@ -354,6 +367,7 @@ protected:
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
@@ -361,8 +375,9 @@ protected:
               constexpr std::array<std::string_view, 7> plan_candidates{
                   "implement",    "refactor", "debug", "benchmark",
                   "stabilize-ci", "document", "ship"};
-              return prefix_filter(partial, plan_candidates);
+              return whole_list(plan_candidates);
             },
+        .narrowable = true,
     });
 
     register_command(opentui::Command{
@@ -389,14 +404,16 @@ protected:
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
 
               constexpr std::array<std::string_view, 4> ask_starters{"can you", "please",
                                                                      "how do I", "why did"};
-              return prefix_filter(partial, ask_starters);
+              return whole_list(ask_starters);
             },
+        .narrowable = true,
     });
 
     register_command(opentui::Command{
@@ -419,6 +436,7 @@ protected:
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
@@ -431,8 +449,9 @@ protected:
                   "git diff",
                   "./scripts/tasks.sh all",
                   "./scripts/tasks.sh run-claude-example"};
-              return prefix_filter(partial, run_candidates);
+              return whole_list(run_candidates);
             },
+        .narrowable = true,
     });
   }
 
@@ -455,16 +474,49 @@ private:
     console.println_color(top_line, opentui::Color::BrightBlack);
   }
 
+  // The names in `directory`, or nullptr if `stop_token` cut the listing short.
+  [[nodiscard]] const opentui::FuzzyIndex* attach_listing(const std::filesystem::path& directory,
+                                                          const std::stop_token& stop_token) {
+    std::error_code error;
+    const std::filesystem::file_time_type modified =
+        std::filesystem::last_write_time(directory, error);
+    if (const auto found = attach_listings_.find(directory);
+        found != attach_listings_.end() && !error && found->second.modified == modified) {
+      return &found->second.names;
+    }
+
+    std::optional<std::vector<std::string>> names = list_directory(directory, stop_token);
+    if (!names.has_value()) {
+      return nullptr;
+    }
+    if (attach_listings_.size() >= kMaxDirectoryListings) {
+      attach_listings_.clear();
+    }
+    DirectoryListing& listing = attach_listings_[directory];
+    listing.modified = modified;
+    listing.names.assign(*names);
+    return &listing.names;
+  }
+
   std::string model_ = "claude-sonnet-4.5";
   std::string theme_ = "dark";
   std::string focus_ = "code edits";
   std::vector<std::string> attached_files_;
+  // Directories /attach has completed in, listed once each, so that every keystroke and page
+  // searches the listing instead of reading the directory again. A listing is read again once
+  // its directory has been modified. Only the completion thread touches them.
+  struct DirectoryListing {
+    std::filesystem::file_time_type modified{};
+    opentui::FuzzyIndex names;
+  };
+  static constexpr std::size_t kMaxDirectoryListings = 16;
+  std::map<std::filesystem::path, DirectoryListing> attach_listings_;
   std::size_t token_estimate_{0U};
 };
 
 } // namespace
 
-int main() {
+int main(int argc, char** argv) {
   ClaudeCodeStyleDemo app;
-  return app.run();
+  return app.run(argc, argv);
 }
@@ -1,7 +1,7 @@
-#include <algorithm>
 #include <charconv>
+#include <chrono>
+#include <cstdint>
 #include <optional>
-#include <ranges>
 #include <string>
 #include <string_view>
 #include <utility>
@@ -65,14 +65,13 @@ protected:
         .description = "Increment program counter by N (default: 1).",
         .handler =
             [this](const opentui::Args& args, opentui::CommandContext& context) {
-              static_cast<void>(context);
-
               int increment = 1;
               if (!args.empty()) {
                 const auto parsed = parse_int(args.front());
                 if (!parsed.has_value() || *parsed <= 0) {
                   console().println_color("Usage: step [positive_integer]",
                                           opentui::Color::BrightRed);
+                  context.failed = true;
                   return;
                 }
                 increment = *parsed;
@@ -90,10 +89,9 @@ protected:
         .description = "Set trace mode: on|off.",
         .handler =
             [this](const opentui::Args& args, opentui::CommandContext& context) {
-              static_cast<void>(context);
-
               if (args.size() != 1U) {
                 console().println_color("Usage: trace <on|off>", opentui::Color::BrightRed);
+                context.failed = true;
                 return;
               }
 
@@ -110,24 +108,18 @@ protected:
               }
 
               console().println_color("Usage: trace <on|off>", opentui::Color::BrightRed);
+              context.failed = true;
             },
         .completer =
             [](const std::string_view partial, const opentui::Args& args) {
+              // The registry matches the whole list against the partial argument.
+              static_cast<void>(partial);
               if (!args.empty()) {
                 return std::vector<std::string>{};
               }
-
-              std::vector<std::string> options{"on", "off"};
-              if (partial.empty()) {
-                return options;
-              }
-
-              std::vector<std::string> filtered;
-              std::ranges::copy_if(
-                  options, std::back_inserter(filtered),
-                  [partial](std::string_view option) { return option.starts_with(partial); });
-              return filtered;
+              return std::vector<std::string>{"on", "off"};
             },
+        .narrowable = true,
     });
 
     register_command(opentui::Command{
@@ -135,11 +127,10 @@ protected:
         .description = "Send UDP message: udp_send <host> <port> <message>",
         .handler =
             [this](const opentui::Args& args, opentui::CommandContext& context) {
-              static_cast<void>(context);
-
               if (args.size() < 3U) {
                 console().println_color("Usage: udp_send <host> <port> <message>",
                                         opentui::Color::BrightRed);
+                context.failed = true;
                 return;
               }
 
@@ -147,6 +138,7 @@ protected:
               const auto parsed_port = parse_int(args[1]);
               if (!parsed_port.has_value() || *parsed_port <= 0 || *parsed_port > 65535) {
                 console().println_color("Invalid UDP port.", opentui::Color::BrightRed);
+                context.failed = true;
                 return;
               }
 
@@ -164,6 +156,7 @@ protected:
 
               if (!sent) {
                 console().println_color("UDP send failed: " + error, opentui::Color::BrightRed);
+                context.failed = true;
                 return;
               }
 
@@ -174,46 +167,50 @@ protected:
 
     register_command(opentui::Command{
         .name = "udp_wait",
-        .description = "Wait for UDP packet: udp_wait <port> [timeout_ms]",
-        .handler =
-            [this](const opentui::Args& args, opentui::CommandContext& context) {
-              static_cast<void>(context);
-
-              if (args.empty() || args.size() > 2U) {
-                console().println_color("Usage: udp_wait <port> [timeout_ms]",
-                                        opentui::Color::BrightRed);
-                return;
-              }
-
-              const auto parsed_port = parse_int(args.front());
-              if (!parsed_port.has_value() || *parsed_port <= 0 || *parsed_port > 65535) {
-                console().println_color("Invalid UDP port.", opentui::Color::BrightRed);
-                return;
-              }
-
-              int timeout_ms = 3000;
-              if (args.size() == 2U) {
-                const auto parsed_timeout = parse_int(args[1]);
-                if (!parsed_timeout.has_value() || *parsed_timeout < 0) {
-                  console().println_color("Invalid timeout value.", opentui::Color::BrightRed);
-                  return;
-                }
-                timeout_ms = *parsed_timeout;
-              }
-
-              std::string error;
-              const auto message =
-                  udp_client_.receive_once(static_cast<std::uint16_t>(*parsed_port),
-                                           std::chrono::milliseconds(timeout_ms), &error);
-
-              if (!message.has_value()) {
-                console().println_color("UDP wait failed: " + error, opentui::Color::BrightRed);
-                return;
-              }
-
-              console().println_color("Received: " + *message, opentui::Color::BrightGreen);
-            },
+        .description = "Wait for UDP packet in the background: udp_wait <port> [timeout_ms]",
         .completer = nullptr,
+        .async_handler = [this](const opentui::Args& args,
+                                opentui::CommandContext& context) -> opentui::CommandTask {
+          if (args.empty() || args.size() > 2U) {
+            console().println_color("Usage: udp_wait <port> [timeout_ms]",
+                                    opentui::Color::BrightRed);
+            context.failed = true;
+            return {};
+          }
+
+          const auto parsed_port = parse_int(args.front());
+          if (!parsed_port.has_value() || *parsed_port <= 0 || *parsed_port > 65535) {
+            console().println_color("Invalid UDP port.", opentui::Color::BrightRed);
+            context.failed = true;
+            return {};
+          }
+
+          int timeout_ms = 3000;
+          if (args.size() == 2U) {
+            const auto parsed_timeout = parse_int(args[1]);
+            if (!parsed_timeout.has_value() || *parsed_timeout < 0) {
+              console().println_color("Invalid timeout value.", opentui::Color::BrightRed);
+              context.failed = true;
+              return {};
+            }
+            timeout_ms = *parsed_timeout;
+          }
+
+          return [this, port = static_cast<std::uint16_t>(*parsed_port),
+                  timeout = std::chrono::milliseconds(timeout_ms)](
+                     opentui::CommandContext& job) {
+            std::string error;
+            const auto message = udp_client_.receive_once(port, timeout, job.stop_token, &error);
+            if (message.has_value()) {
+              job.console.post("Received: " + *message,
+                               opentui::Style{opentui::Color::BrightGreen});
+            } else if (!job.stop_token.stop_requested()) {
+              job.console.post("UDP wait failed: " + error,
+                               opentui::Style{opentui::Color::BrightRed});
+              job.failed = true;
+            }
+          };
+        },
     });
   }
 
@@ -225,7 +222,7 @@ private:
 
 } // namespace
 
-int main() {
+int main(int argc, char** argv) {
   DebuggerApp app;
-  return app.run();
+  return app.run(argc, argv);
 }
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace opentui::ansi {
+
+inline constexpr std::string_view kClearToLineEnd = "\033[K";
+inline constexpr std::string_view kClearToScreenEnd = "\033[J";
+inline constexpr std::string_view kCursorUp = "\033[A";
+inline constexpr std::string_view kCursorDown = "\033[B";
+// DEC private mode 2026: the terminal holds rendering until the matching end sequence.
+inline constexpr std::string_view kBeginSynchronizedUpdate = "\033[?2026h";
+inline constexpr std::string_view kEndSynchronizedUpdate = "\033[?2026l";
+
+void append_number(std::string& output, std::size_t value);
+
+// Length of CSI [n] <final>; the parameter is omitted when it is 1.
+[[nodiscard]] std::size_t cursor_sequence_length(std::size_t count) noexcept;
+// Appends CSI [n] <final>, e.g. final 'C' moves the cursor `count` columns right.
+void append_cursor_sequence(std::string& output, std::size_t count, char final_byte);
+
+// Zero-based absolute cursor position (CUP).
+[[nodiscard]] std::size_t absolute_move_length(std::size_t row, std::size_t column) noexcept;
+void append_absolute_move(std::string& output, std::size_t row, std::size_t column);
+
+// Length of the shortest sequence that moves the cursor within a line from column `from` to `to`.
+[[nodiscard]] std::size_t horizontal_move_length(std::size_t from, std::size_t to) noexcept;
+void append_horizontal_move(std::string& output, std::size_t from, std::size_t to);
+
+// Heuristic support check for synchronized output; OPEN_TUI_SYNC_OUTPUT=0/1 overrides it.
+[[nodiscard]] bool terminal_supports_synchronized_output();
+
+// Width of the terminal on standard output, or 0 when it is not a terminal.
+[[nodiscard]] std::size_t terminal_columns() noexcept;
+
+} // namespace opentui::ansi
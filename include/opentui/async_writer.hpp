@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opentui {
+
+enum class BackpressurePolicy {
+  // The submitting thread waits until the writer has caught up.
+  Block,
+  // Queued buffers are discarded, oldest first, to make room.
+  DropOldest,
+  // Like DropOldest, but a one-line summary of the dropped lines is written in their place.
+  Summarize,
+};
+
+struct AsyncWriterOptions {
+  std::size_t max_queued_bytes{1024U * 1024U};
+  BackpressurePolicy policy{BackpressurePolicy::Block};
+};
+
+struct AsyncWriterStats {
+  std::uint64_t buffers_written{0};
+  std::uint64_t bytes_written{0};
+  std::uint64_t write_calls{0};
+  std::uint64_t buffers_dropped{0};
+  std::uint64_t bytes_dropped{0};
+  std::uint64_t producer_waits{0};
+};
+
+// Owns a file descriptor on a dedicated thread so that producers never block on a slow terminal,
+// pipe or pty. Buffers are written in submission order; when more than `max_queued_bytes` are
+// waiting the configured policy decides between blocking and dropping. Dropping can cut escape
+// sequences short, so the drop policies suit log-style output rather than cursor-addressed frames.
+class AsyncWriter {
+public:
+  explicit AsyncWriter(int file_descriptor, AsyncWriterOptions options = {});
+  // Writes everything still queued before joining the writer thread.
+  ~AsyncWriter();
+
+  AsyncWriter(const AsyncWriter&) = delete;
+  AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+  void submit(std::string buffer);
+  // Returns an empty buffer, reusing the capacity of one that was already written when possible.
+  [[nodiscard]] std::string acquire_buffer();
+  // Blocks until every submitted buffer has reached the file descriptor.
+  void wait_idle();
+
+  [[nodiscard]] const AsyncWriterOptions& options() const noexcept;
+  [[nodiscard]] AsyncWriterStats stats() const;
+  // The byte counts of stats(), readable without taking the writer's lock.
+  [[nodiscard]] std::uint64_t bytes_written() const noexcept;
+  [[nodiscard]] std::uint64_t bytes_dropped() const noexcept;
+
+private:
+  static constexpr std::size_t kMaxSpareBuffers = 4;
+
+  void run();
+  void write_all(std::string_view bytes);
+
+  int file_descriptor_;
+  AsyncWriterOptions options_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable queue_not_empty_;
+  std::condition_variable queue_not_full_;
+  std::condition_variable idle_;
+  std::deque<std::string> queue_;
+  std::vector<std::string> spare_buffers_;
+  std::size_t queued_bytes_{0};
+  std::uint64_t dropped_lines_{0};
+  bool writing_{false};
+  bool stopping_{false};
+  AsyncWriterStats stats_;
+  std::atomic_uint64_t bytes_written_{0};
+  std::atomic_uint64_t bytes_dropped_{0};
+
+  bool last_write_ended_line_{true};
+  std::thread thread_;
+};
+
+} // namespace opentui
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace opentui {
+
+// Levenshtein distance in bytes: the fewest single-byte insertions, deletions and substitutions
+// that turn one string into the other. Distances above `limit` are reported as `limit + 1`, which
+// lets most pairs of dissimilar strings stop early.
+[[nodiscard]] std::size_t
+edit_distance(std::string_view left, std::string_view right,
+              std::size_t limit = std::numeric_limits<std::size_t>::max());
+
+struct BkMatch {
+  std::string_view word;
+  std::string_view value;
+  std::size_t distance{0};
+};
+
+// Burkhard-Keller tree over edit distance. Each child hangs off its parent by its distance from
+// it, so by the triangle inequality a search within k edits of a query at distance d from a node
+// only descends into children whose edge lies in [d - k, d + k]. For small k this visits a small
+// fraction of the words, and the fraction shrinks as the tree grows.
+//
+// Words and values are viewed, not copied, and must outlive the tree. Nodes live in one vector and
+// link to their children through indices, so adding a word allocates nothing beyond that vector.
+class BkTree {
+public:
+  // Adds `word`, reported with `value` when it matches. The same word may be added more than once.
+  void add(std::string_view word, std::string_view value);
+  [[nodiscard]] std::size_t size() const noexcept;
+
+  // Replaces `matches` with every word within `max_distance` edits of `query`, nearest first and
+  // alphabetical among equals.
+  void find_within(std::string_view query, std::size_t max_distance,
+                   std::vector<BkMatch>& matches) const;
+
+private:
+  static constexpr std::uint32_t kNoNode = UINT32_MAX;
+
+  struct Node {
+    std::string_view word;
+    std::string_view value;
+    std::uint32_t distance{0};
+    std::uint32_t max_child_distance{0};
+    std::uint32_t first_child{kNoNode};
+    std::uint32_t next_sibling{kNoNode};
+  };
+
+  std::vector<Node> nodes_;
+};
+
+} // namespace opentui
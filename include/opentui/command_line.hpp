@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace opentui {
+
+using Args = std::vector<std::string>;
+
+// Arguments of one command line, viewing the line itself or the TokenizedLine that split it; valid
+// until either changes. Converts implicitly to Args, so handlers written against Args keep working
+// at the cost of one copy per call.
+class ArgsView {
+public:
+  using iterator = std::span<const std::string_view>::iterator;
+
+  ArgsView() noexcept = default;
+  ArgsView(std::span<const std::string_view> tokens) noexcept : tokens_(tokens) {}
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return tokens_.size();
+  }
+  [[nodiscard]] bool empty() const noexcept {
+    return tokens_.empty();
+  }
+  [[nodiscard]] std::string_view operator[](const std::size_t index) const noexcept {
+    return tokens_[index];
+  }
+  [[nodiscard]] std::string_view front() const noexcept {
+    return tokens_.front();
+  }
+  [[nodiscard]] std::string_view back() const noexcept {
+    return tokens_.back();
+  }
+  [[nodiscard]] iterator begin() const noexcept {
+    return tokens_.begin();
+  }
+  [[nodiscard]] iterator end() const noexcept {
+    return tokens_.end();
+  }
+  [[nodiscard]] ArgsView subview(const std::size_t offset,
+                                 const std::size_t count = std::dynamic_extent) const noexcept {
+    return tokens_.subspan(offset, count);
+  }
+
+  operator Args() const {
+    return {tokens_.begin(), tokens_.end()};
+  }
+
+private:
+  std::span<const std::string_view> tokens_;
+};
+
+// Splits a command line into whitespace-separated tokens. Single or double quotes group words and
+// a backslash takes the next character literally; quoted empty strings produce no token. Tokens
+// that need no rewriting view the line directly, which must therefore outlive them, and the rest
+// are unquoted into one arena sized for the whole line. Reusing a TokenizedLine across lines reuses
+// both buffers, so steady-state tokenizing allocates nothing.
+class TokenizedLine {
+public:
+  TokenizedLine() = default;
+  explicit TokenizedLine(std::string_view line);
+
+  void assign(std::string_view line);
+
+  [[nodiscard]] ArgsView tokens() const noexcept {
+    return std::span<const std::string_view>{tokens_};
+  }
+  [[nodiscard]] std::size_t size() const noexcept {
+    return tokens_.size();
+  }
+  [[nodiscard]] bool empty() const noexcept {
+    return tokens_.empty();
+  }
+
+  TokenizedLine(const TokenizedLine&) = delete;
+  TokenizedLine& operator=(const TokenizedLine&) = delete;
+
+private:
+  std::string arena_;
+  std::vector<std::string_view> tokens_;
+};
+
+// Replaces `words` with views of the whitespace-separated words of `text`, without any quoting.
+void split_words(std::string_view text, std::vector<std::string_view>& words);
+
+} // namespace opentui
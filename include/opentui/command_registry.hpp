@@ -1,51 +1,190 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <optional>
+#include <stop_token>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "opentui/bk_tree.hpp"
+#include "opentui/command_line.hpp"
+#include "opentui/command_table.hpp"
+#include "opentui/completion_cache.hpp"
+#include "opentui/completion_page.hpp"
+
 namespace opentui {
 
 class Console;
-
-using Args = std::vector<std::string>;
+class JobManager;
 
 struct CommandContext {
   Console& console;
   std::atomic_bool& running;
+  // Set by a handler to report that its command failed; execute_line() then returns false.
+  bool failed{false};
+  // Signalled when a background task should give up, as by `kill`. Never signalled for handlers
+  // running on the input thread.
+  std::stop_token stop_token{};
+  // Where tasks returned by async handlers run. Without one they run to completion in place.
+  JobManager* jobs{nullptr};
 };
 
-using CommandHandler = std::function<void(const Args& args, CommandContext& context)>;
+// Handlers may take `const Args&` instead of ArgsView; the arguments are then copied for each call.
+using CommandHandler = std::function<void(ArgsView args, CommandContext& context)>;
+// Work an async handler hands off to run in the background. It gets its own CommandContext and
+// runs on another thread, where the console may only be used through Console::post().
+using CommandTask = std::function<void(CommandContext& context)>;
+// Runs on the input thread to check the arguments and capture what the task needs; returning an
+// empty task, for example after a usage error, starts nothing.
+using AsyncCommandHandler = std::function<CommandTask(ArgsView args, CommandContext& context)>;
+// Completers run on the line editor's completion thread while the prompt is active; command
+// handlers never run at the same time, so reading state they modify needs no locking. Background
+// tasks can, so state a task modifies needs its own synchronization.
 using CompletionHandler =
-    std::function<std::vector<std::string>(std::string_view partial, const Args& args)>;
+    std::function<std::vector<std::string>(std::string_view partial, ArgsView args)>;
+// For argument lists too large to build on every keystroke, such as a directory of 100k files.
+// Appends up to `count` entries of the full list, best match first, starting at `offset`, to `page`
+// and returns the length of the full list. Runs where a CompletionHandler would; once `stop_token`
+// is signalled the page is discarded, so a slow listing should give up early.
+using PagedCompletionHandler = std::function<std::size_t(
+    std::string_view partial, ArgsView args, std::size_t offset, std::size_t count,
+    std::vector<std::string>& page, std::stop_token stop_token)>;
 
 struct Command {
   std::string name;
   std::string description;
   CommandHandler handler;
   CompletionHandler completer;
+  // Set when the completer's results for a longer partial token are always its results for a
+  // shorter one that still fuzzy-match the longer token, as when it returns a fixed list. The
+  // completer then runs once per token and later keystrokes search the list it returned; results
+  // that do not match the token are left out. Without it, they are listed after the matches.
+  bool narrowable{false};
+  // Set instead of `handler` for commands that run as background jobs.
+  AsyncCommandHandler async_handler{};
+  // Set instead of `completer` to have arguments completed a page at a time.
+  PagedCompletionHandler paged_completer{};
+};
+
+struct ScriptOptions {
+  static constexpr std::size_t kDefaultChunkBytes = 256U * 1024U;
+
+  // Input is read this many bytes at a time, and output is flushed once per chunk.
+  std::size_t chunk_bytes{kDefaultChunkBytes};
+  bool stop_on_error{false};
+  // Called after each command with its 1-based line number, the line and whether it succeeded.
+  std::function<void(std::size_t line_number, std::string_view line, bool succeeded)> on_command;
+};
+
+struct ScriptResult {
+  std::size_t commands{0};
+  std::size_t failed{0};
+  // Line numbers of the failed commands, in order.
+  std::vector<std::size_t> failed_lines;
+  // Set when stop_on_error or a command clearing `running` ended the script early.
+  bool stopped{false};
+};
+
+// Handler and completer for the command of a CommandTable called `name`.
+struct CommandBinding {
+  std::string_view name;
+  CommandHandler handler;
+  CompletionHandler completer;
+  AsyncCommandHandler async_handler{};
 };
 
 class CommandRegistry {
 public:
+  CommandRegistry() = default;
+
+  // The name indices view the registry's own map keys. Map nodes keep their address when the
+  // registry is moved, but a copy's indices would point into the original.
+  CommandRegistry(const CommandRegistry&) = delete;
+  CommandRegistry& operator=(const CommandRegistry&) = delete;
+  CommandRegistry(CommandRegistry&&) = default;
+  CommandRegistry& operator=(CommandRegistry&&) = default;
+  ~CommandRegistry() = default;
+
   [[nodiscard]] bool add(Command command);
+  // Adds every command of `table`, bound to the entry of `bindings` with its name (not an alias),
+  // in any order. Each command and all its aliases share one record, and lookups try the table's
+  // perfect hash before the map of commands added one by one. The table must outlive the
+  // registry. Adds nothing and returns false if a command is left unbound, a binding names no
+  // command of the table or one already bound, a binding has no handler, or a name is already
+  // taken.
+  [[nodiscard]] bool add_table(CommandTableView table, std::vector<CommandBinding> bindings);
   [[nodiscard]] bool contains(std::string_view name) const;
   [[nodiscard]] std::optional<std::reference_wrapper<const Command>>
   find(std::string_view name) const;
   [[nodiscard]] std::vector<std::string> names() const;
+  // Replaces `matches` with the names, in order, of every command whose name starts with `prefix`
+  // either literally or with its leading slash omitted. Costs O(log n + prefix + results) and
+  // allocates nothing once `matches` has grown to fit.
+  void names_with_prefix(std::string_view prefix, std::vector<std::string_view>& matches) const;
+  // Replaces `matches` with up to `limit` names within a few edits of `token`, literally or with
+  // their leading slash omitted, closest first. Tokens of three bytes or fewer allow one edit and
+  // longer ones two.
+  void names_near(std::string_view token, std::size_t limit,
+                  std::vector<std::string_view>& matches) const;
   [[nodiscard]] std::vector<std::string> complete(std::string_view buffer) const;
+  // Like complete(), reusing lists cached earlier in the same editing session.
+  [[nodiscard]] std::vector<std::string> complete(std::string_view buffer,
+                                                  CompletionCache& cache) const;
+  // Entries [offset, offset + count) of complete(buffer, cache). Paged completers are asked for
+  // just that page; other lists are indexed once (see CompletionCache) and only their best
+  // offset + count matches are ranked.
+  // `stop_token` is passed on to paged completers; once it is signalled the page comes back empty
+  // and nothing is cached.
+  [[nodiscard]] CompletionPage complete_page(std::string_view buffer, std::size_t offset,
+                                             std::size_t count, CompletionCache& cache,
+                                             std::stop_token stop_token = {}) const;
   [[nodiscard]] std::string help_text() const;
 
   bool execute_line(std::string_view line, CommandContext& context) const;
+  // Like execute_line(), tokenizing into `tokens` so that callers running many lines reuse its
+  // storage. The handler sees views into `line` and `tokens`.
+  bool execute_line(std::string_view line, CommandContext& context, TokenizedLine& tokens) const;
+
+  // Runs every line of `input` as a command. Blank lines and lines starting with '#' are skipped,
+  // and a trailing '\r' is dropped. Lines are sliced out of large chunks and tokenized into one
+  // reused TokenizedLine, so steady-state dispatch allocates nothing outside the handlers.
+  [[nodiscard]] ScriptResult run_script(std::istream& input, CommandContext& context,
+                                        const ScriptOptions& options = {}) const;
 
 private:
-  [[nodiscard]] static Args tokenize(std::string_view line);
+  struct BoundTable {
+    CommandTableView table;
+    std::vector<Command> commands;
+  };
+
+  // The list completing `buffer`: `list` searched for `partial`, each entry between `prefix`
+  // and `suffix`, and with `keep_unmatched` the entries not matching listed after the rest.
+  struct CompletionSource {
+    const FuzzyIndex* list{nullptr};
+    std::string_view partial{};
+    std::string prefix{};
+    std::string_view suffix{};
+    bool keep_unmatched{false};
+  };
+
+  void index_name(std::string_view name);
+  [[nodiscard]] CompletionSource completion_source(std::string_view buffer,
+                                                   CompletionCache& cache) const;
 
+  std::vector<BoundTable> tables_;
   std::map<std::string, Command, std::less<>> commands_;
+  // Views of table names and map keys, which stay put for the registry's lifetime. `name_views_`
+  // lists every name in order; `unslashed_names_` lists names starting with '/' ordered by the
+  // rest, so both spellings of a name can be prefix-searched without a scan.
+  std::vector<std::string_view> name_views_;
+  std::vector<std::string_view> unslashed_names_;
+  // Every name, and every name starting with '/' once more without it, by edit distance.
+  BkTree names_by_spelling_;
 };
 
 } // namespace opentui
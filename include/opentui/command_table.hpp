@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace opentui {
+
+// One command of a CommandTable. Aliases resolve to the same command; unused alias slots stay
+// empty.
+struct CommandSpec {
+  static constexpr std::size_t kMaxAliases = 4;
+
+  std::string_view name;
+  std::string_view description;
+  std::array<std::string_view, kMaxAliases> aliases{};
+  // As Command::narrowable.
+  bool narrowable{false};
+};
+
+struct CommandTableName {
+  std::string_view name;
+  std::uint32_t command{0};
+};
+
+// Seeded FNV-1a with a final mix so that different seeds give unrelated low bits.
+[[nodiscard]] constexpr std::uint64_t command_name_hash(std::string_view name,
+                                                        const std::uint64_t seed) noexcept {
+  std::uint64_t hash = 0xcbf29ce484222325ULL ^ (seed * 0x9e3779b97f4a7c15ULL);
+  for (const char character : name) {
+    hash ^= static_cast<unsigned char>(character);
+    hash *= 0x100000001b3ULL;
+  }
+  hash ^= hash >> 32U;
+  hash *= 0xd6e8feb86659fd93ULL;
+  hash ^= hash >> 32U;
+  return hash;
+}
+
+// A CommandTable with its size erased, as the registry stores it.
+class CommandTableView {
+public:
+  static constexpr std::uint64_t kBucketSeed = 0;
+
+  constexpr CommandTableView(std::span<const CommandSpec> commands,
+                             std::span<const CommandTableName> slots,
+                             std::span<const std::int32_t> displacements) noexcept
+      : commands_(commands), slots_(slots), displacements_(displacements) {}
+
+  // The command that `name` or one of its aliases names. Hashes the name at most twice and
+  // compares it once.
+  [[nodiscard]] constexpr std::optional<std::size_t> find(std::string_view name) const noexcept {
+    const std::size_t mask = slots_.size() - 1U;
+    const std::int32_t displacement =
+        displacements_[command_name_hash(name, kBucketSeed) & mask];
+    if (displacement == 0) {
+      return std::nullopt;
+    }
+
+    const std::size_t slot =
+        displacement < 0
+            ? static_cast<std::size_t>(-displacement - 1)
+            : command_name_hash(name, static_cast<std::uint64_t>(displacement)) & mask;
+    if (slots_[slot].name != name) {
+      return std::nullopt;
+    }
+    return slots_[slot].command;
+  }
+
+  [[nodiscard]] constexpr std::span<const CommandSpec> commands() const noexcept {
+    return commands_;
+  }
+  // Every name and alias, in no particular order, among empty slots.
+  [[nodiscard]] constexpr std::span<const CommandTableName> slots() const noexcept {
+    return slots_;
+  }
+
+private:
+  std::span<const CommandSpec> commands_;
+  std::span<const CommandTableName> slots_;
+  std::span<const std::int32_t> displacements_;
+};
+
+// Command names and aliases resolved through a perfect hash built at compile time, by hash and
+// displace: names are grouped into buckets by one hash, then each bucket, largest first, gets the
+// seed of a second hash that sends all its names to free slots. Single-name buckets point
+// straight at a slot. A lookup is then one bucket read, one hash and one string comparison.
+//
+// Declare tables constexpr, with static storage duration; a duplicate or empty name fails to
+// compile.
+template <std::size_t Commands> class CommandTable {
+public:
+  static constexpr std::size_t kSlots =
+      std::bit_ceil(2U * Commands * (1U + CommandSpec::kMaxAliases));
+
+  consteval explicit CommandTable(const std::array<CommandSpec, Commands>& commands)
+      : commands_(commands) {
+    std::array<CommandTableName, kSlots / 2U> names{};
+    std::size_t name_count = 0;
+    for (std::size_t command = 0; command < Commands; ++command) {
+      add_name(names, name_count, commands[command].name, command);
+      for (const std::string_view alias : commands[command].aliases) {
+        if (!alias.empty()) {
+          add_name(names, name_count, alias, command);
+        }
+      }
+    }
+
+    constexpr std::size_t kMask = kSlots - 1U;
+    std::array<std::size_t, kSlots> bucket_of{};
+    std::array<std::size_t, kSlots> bucket_size{};
+    std::size_t largest_bucket = 0;
+    for (std::size_t index = 0; index < name_count; ++index) {
+      bucket_of[index] =
+          command_name_hash(names[index].name, CommandTableView::kBucketSeed) & kMask;
+      largest_bucket = std::max(largest_bucket, ++bucket_size[bucket_of[index]]);
+    }
+
+    std::array<bool, kSlots> taken{};
+    for (std::size_t size = largest_bucket; size > 1U; --size) {
+      for (std::size_t bucket = 0; bucket < kSlots; ++bucket) {
+        if (bucket_size[bucket] == size) {
+          place_bucket(names, name_count, bucket_of, bucket, taken);
+        }
+      }
+    }
+
+    std::size_t free_slot = 0;
+    for (std::size_t index = 0; index < name_count; ++index) {
+      if (bucket_size[bucket_of[index]] != 1U) {
+        continue;
+      }
+      while (taken[free_slot]) {
+        ++free_slot;
+      }
+      taken[free_slot] = true;
+      slots_[free_slot] = names[index];
+      displacements_[bucket_of[index]] = -static_cast<std::int32_t>(free_slot) - 1;
+    }
+  }
+
+  [[nodiscard]] constexpr CommandTableView view() const noexcept {
+    return {commands_, slots_, displacements_};
+  }
+
+  [[nodiscard]] constexpr std::optional<std::size_t> find(std::string_view name) const noexcept {
+    return view().find(name);
+  }
+
+private:
+  static consteval void add_name(std::array<CommandTableName, kSlots / 2U>& names,
+                                 std::size_t& name_count, const std::string_view name,
+                                 const std::size_t command) {
+    if (name.empty()) {
+      throw "command names must not be empty";
+    }
+    for (std::size_t index = 0; index < name_count; ++index) {
+      if (names[index].name == name) {
+        throw "command name registered twice";
+      }
+    }
+    names[name_count++] = {.name = name, .command = static_cast<std::uint32_t>(command)};
+  }
+
+  consteval void place_bucket(const std::array<CommandTableName, kSlots / 2U>& names,
+                              const std::size_t name_count,
+                              const std::array<std::size_t, kSlots>& bucket_of,
+                              const std::size_t bucket, std::array<bool, kSlots>& taken) {
+    constexpr std::size_t kMask = kSlots - 1U;
+    for (std::int32_t displacement = 1;; ++displacement) {
+      std::array<bool, kSlots> trial = taken;
+      bool fits = true;
+      for (std::size_t index = 0; index < name_count && fits; ++index) {
+        if (bucket_of[index] != bucket) {
+          continue;
+        }
+        const std::size_t slot =
+            command_name_hash(names[index].name, static_cast<std::uint64_t>(displacement)) &
+            kMask;
+        fits = !trial[slot];
+        trial[slot] = true;
+      }
+      if (!fits) {
+        continue;
+      }
+
+      for (std::size_t index = 0; index < name_count; ++index) {
+        if (bucket_of[index] == bucket) {
+          slots_[command_name_hash(names[index].name, static_cast<std::uint64_t>(displacement)) &
+                 kMask] = names[index];
+        }
+      }
+      taken = trial;
+      displacements_[bucket] = displacement;
+      return;
+    }
+  }
+
+  std::array<CommandSpec, Commands> commands_;
+  std::array<CommandTableName, kSlots> slots_{};
+  std::array<std::int32_t, kSlots> displacements_{};
+};
+
+} // namespace opentui
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/fuzzy_matcher.hpp"
+
+namespace opentui {
+
+struct CompletionCacheStats {
+  std::uint64_t exact_hits{0};
+  std::uint64_t narrowed{0};
+  std::uint64_t misses{0};
+};
+
+// Candidate lists for one line-editing session, each indexed once for fuzzy search. A list is
+// kept with the scope and partial token it was computed for, so that backspacing to that token
+// or extending it searches the same index instead of computing the list again. Call clear()
+// whenever the state completers depend on may have changed, e.g. before each prompt.
+class CompletionCache {
+public:
+  static constexpr std::size_t kMaxLists = 32;
+
+  // The list recorded for the longest cached partial token in `scope` that is a prefix of
+  // `partial`, or nullptr when the list has to be computed. Valid until the next store_list().
+  [[nodiscard]] const FuzzyIndex* narrowest_list(std::string_view scope, std::string_view partial);
+  const FuzzyIndex& store_list(std::string_view scope, std::string_view partial, FuzzyIndex list);
+
+  void clear() noexcept;
+
+  [[nodiscard]] const CompletionCacheStats& stats() const noexcept;
+
+private:
+  struct ListEntry {
+    std::string scope;
+    std::string partial;
+    FuzzyIndex list;
+  };
+
+  std::vector<ListEntry> lists_;
+  CompletionCacheStats stats_;
+};
+
+} // namespace opentui
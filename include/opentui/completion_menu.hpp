@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace opentui {
+
+// A scrollable list of completion candidates shown below the input line. The menu holds only the
+// selection and scroll position; candidates are passed in when rows are built, and only the rows
+// in view are formatted, so a frame costs the same for ten candidates as for a hundred thousand.
+class CompletionMenu {
+public:
+  static constexpr std::size_t kDefaultHeight = 8;
+  // Wider candidates are truncated with an ellipsis.
+  static constexpr std::size_t kMaxCandidateWidth = 72;
+
+  explicit CompletionMenu(std::size_t height = kDefaultHeight) noexcept;
+
+  // At least one row is always shown.
+  void set_height(std::size_t height) noexcept;
+  [[nodiscard]] std::size_t height() const noexcept;
+
+  // Drops the selection and scrolls back to the top, e.g. when the candidate list is replaced.
+  void reset() noexcept;
+
+  // Moves the selection by `delta` rows among `count` candidates, wrapping around when a single
+  // step passes either end. With nothing selected yet, a forward move selects the first candidate
+  // and a backward one the last. Returns false when there is nothing to select.
+  bool move(std::ptrdiff_t delta, std::size_t count) noexcept;
+  [[nodiscard]] std::optional<std::size_t> selected() const noexcept;
+
+  // Replaces `rows` with the visible part of `candidates`: one row per candidate in view, the
+  // selected one highlighted, followed by a position row when not everything fits. When
+  // `candidates` are the loaded part of a longer list, `total` is that list's length.
+  void build_rows(std::span<const std::string> candidates, std::vector<std::string>& rows,
+                  std::size_t total = 0);
+  // As above for the candidates at `indices`, in that order; only those in view are read.
+  void build_rows(std::span<const std::string> candidates, std::span<const std::uint32_t> indices,
+                  std::vector<std::string>& rows);
+
+private:
+  template <typename CandidateAt>
+  void build_rows_with(std::size_t count, const CandidateAt& candidate_at,
+                       std::vector<std::string>& rows, std::size_t total);
+
+  std::size_t height_;
+  std::size_t top_{0};
+  std::optional<std::size_t> selected_;
+};
+
+} // namespace opentui
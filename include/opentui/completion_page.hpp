@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace opentui {
+
+// A window into a completion list: `candidates` are its entries from `offset` on, and `total` is
+// the length of the whole list.
+struct CompletionPage {
+  std::vector<std::string> candidates{};
+  std::size_t offset{0};
+  std::size_t total{0};
+};
+
+} // namespace opentui
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "opentui/completion_page.hpp"
+#include "opentui/wakeup_signal.hpp"
+
+namespace opentui {
+
+struct CompletionResult {
+  std::uint64_t generation{0};
+  std::string buffer;
+  // Entries [offset, offset + candidates.size()) of the `total` candidates for `buffer`.
+  std::vector<std::string> candidates;
+  std::size_t offset{0};
+  std::size_t total{0};
+  // Set when the provider threw; the exception is rethrown on the input thread.
+  std::exception_ptr error;
+};
+
+// Runs a completion provider on a worker thread so slow completers never block typing. Every
+// request carries a generation number: a request replaced before it starts is never run, and a
+// result finishing after a newer request was made is discarded. A provider still running when its
+// request is superseded or cancelled has stop requested on its token. wakeup() is signalled when a
+// current result is ready.
+class CompletionWorker {
+public:
+  // Returns up to `count` candidates for the buffer, starting at `offset`. Once `stop_token` is
+  // signalled the result is discarded, so a slow provider should return early.
+  using Provider = std::function<CompletionPage(std::string_view buffer, std::size_t offset,
+                                                std::size_t count, std::stop_token stop_token)>;
+
+  CompletionWorker() = default;
+  ~CompletionWorker();
+
+  CompletionWorker(const CompletionWorker&) = delete;
+  CompletionWorker& operator=(const CompletionWorker&) = delete;
+
+  // Must not be called while a request is in flight; see cancel_and_wait().
+  void set_provider(Provider provider);
+
+  // Supersedes any earlier request and returns the new generation.
+  std::uint64_t request(std::string buffer, std::size_t offset, std::size_t count);
+  // Takes the finished result for the newest request, if there is one.
+  [[nodiscard]] std::optional<CompletionResult> take_result();
+  // Waits up to `timeout` for the result of `generation`.
+  [[nodiscard]] std::optional<CompletionResult> wait_for(std::uint64_t generation,
+                                                         std::chrono::milliseconds timeout);
+  // Drops the queued request, asks the running one, if any, to stop and blocks until it has
+  // returned.
+  void cancel_and_wait();
+
+  [[nodiscard]] WakeupSignal& wakeup() noexcept;
+
+private:
+  struct Request {
+    std::uint64_t generation;
+    std::string buffer;
+    std::size_t offset;
+    std::size_t count;
+  };
+
+  void run();
+
+  std::mutex mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable result_available_;
+  Provider provider_;
+  std::optional<Request> pending_;
+  std::optional<CompletionResult> result_;
+  std::uint64_t latest_generation_{0};
+  // Signals the provider call in progress, if any.
+  std::stop_source running_stop_;
+  bool busy_{false};
+  bool stopping_{false};
+  WakeupSignal wakeup_;
+  std::thread thread_;
+};
+
+} // namespace opentui
@@ -1,37 +1,60 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
+
+#include "opentui/async_writer.hpp"
+#include "opentui/mpsc_queue.hpp"
+#include "opentui/output_buffer.hpp"
+#include "opentui/scrollback.hpp"
+#include "opentui/style.hpp"
+#include "opentui/wakeup_signal.hpp"
 
 namespace opentui {
 
-enum class Color {
-  Default = -1,
-  Black = 0,
-  Red = 1,
-  Green = 2,
-  Yellow = 3,
-  Blue = 4,
-  Magenta = 5,
-  Cyan = 6,
-  White = 7,
-  BrightBlack = 8,
-  BrightRed = 9,
-  BrightGreen = 10,
-  BrightYellow = 11,
-  BrightBlue = 12,
-  BrightMagenta = 13,
-  BrightCyan = 14,
-  BrightWhite = 15,
+struct ConsoleRecord {
+  std::string text;
+  Style style;
+};
+
+struct CoalescingOptions {
+  unsigned frames_per_second{30};
+  // A frame that accumulates more lines than this collapses into an elision summary followed by
+  // the most recent lines.
+  std::size_t max_lines_per_frame{200};
+};
+
+struct ConsoleCounters {
+  std::uint64_t lines_submitted{0};
+  std::uint64_t bytes_submitted{0};
+  std::uint64_t lines_elided{0};
+  std::uint64_t frames_presented{0};
+  // Bytes that reached the terminal. With an async writer attached this includes what it has
+  // written so far; what it dropped under backpressure is counted in `bytes_dropped` instead.
+  std::uint64_t bytes_sent{0};
+  std::uint64_t bytes_dropped{0};
 };
 
 class Console {
 public:
   Console();
+  ~Console();
+
+  Console(const Console&) = delete;
+  Console& operator=(const Console&) = delete;
 
   void print(std::string_view text);
   void println(std::string_view text = {});
 
+  void print(std::string_view text, Style style);
+  void println(std::string_view text, Style style);
+
   void print_color(std::string_view text, Color foreground, Color background = Color::Default,
                    bool bold = false);
   void println_color(std::string_view text, Color foreground, Color background = Color::Default,
@@ -40,15 +63,76 @@ public:
   [[nodiscard]] std::string paint(std::string_view text, Color foreground,
                                   Color background = Color::Default, bool bold = false) const;
 
+  // Appends `text` wrapped in the style's escape sequences to a caller-owned buffer.
+  void paint_to(std::string& buffer, std::string_view text, Style style) const;
+
+  // Writes terminal control bytes (cursor motion, redraw frames). Unlike print() this output is
+  // not recorded in the scrollback, and coalescing neither delays nor elides it.
+  void emit(std::string_view bytes);
+
   void flush();
   void clear_screen();
 
+  // Records every printed line in a bounded in-process scrollback store.
+  void enable_scrollback(std::size_t memory_limit = Scrollback::kDefaultMemoryLimit);
+  void disable_scrollback() noexcept;
+  [[nodiscard]] Scrollback* scrollback() noexcept;
+  [[nodiscard]] const Scrollback* scrollback() const noexcept;
+
+  // Thread-safe and non-blocking: queues a finished line for the render owner (the thread running
+  // LineEditor::read_line) to print above the prompt.
+  void post(std::string line, Style style = {});
+  // Render owner only: moves every queued record into the frame buffer. Returns the count.
+  std::size_t drain_posted();
+  [[nodiscard]] bool has_posted() const noexcept;
+  [[nodiscard]] WakeupSignal& wakeup() noexcept;
+
+  // Coalescing mode: output accumulates and reaches the terminal at most `frames_per_second`
+  // times per second (or on flush()); bursts that outrun that rate are elided down to their tail.
+  void enable_coalescing(CoalescingOptions options = {});
+  void disable_coalescing();
+  [[nodiscard]] bool coalescing() const noexcept;
+
+  // Moves terminal writes onto a dedicated thread so a slow terminal or pipe does not stall the
+  // caller; flush() then hands the frame over instead of writing it.
+  void enable_async_writer(AsyncWriterOptions options = {});
+  // Waits for queued output to be written and returns to writing on the calling thread.
+  void disable_async_writer();
+  [[nodiscard]] const AsyncWriter* async_writer() const noexcept;
+
+  void set_auto_flush_threshold(std::size_t bytes) noexcept;
+  [[nodiscard]] const OutputStats& output_stats() const noexcept;
+  [[nodiscard]] ConsoleCounters counters() const noexcept;
+
 private:
+  using Clock = std::chrono::steady_clock;
+
   [[nodiscard]] static bool enable_virtual_terminal();
-  [[nodiscard]] static int ansi_foreground(Color color);
-  [[nodiscard]] static int ansi_background(Color color);
+
+  void write(std::string_view text);
+  void write_control(std::string_view bytes);
+  void write_line_end();
+  void record(std::string_view text);
+  void stage(std::string_view text);
+  void elide_pending(std::size_t keep_lines);
+  void present_pending();
 
   bool ansi_enabled_{false};
+  std::unique_ptr<AsyncWriter> async_writer_;
+  OutputBuffer output_;
+  ConsoleCounters counters_;
+  std::unique_ptr<Scrollback> scrollback_;
+
+  bool coalescing_{false};
+  CoalescingOptions coalescing_options_;
+  Clock::duration frame_interval_{};
+  Clock::time_point last_present_{};
+  std::string pending_;
+  std::vector<std::size_t> pending_line_ends_;
+  std::uint64_t pending_elided_{0};
+  MpscQueue<ConsoleRecord> posted_;
+  std::atomic_size_t posted_count_{0};
+  WakeupSignal wakeup_;
 };
 
 } // namespace opentui
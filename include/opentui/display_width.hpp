@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace opentui {
+
+struct DecodedCodepoint {
+  char32_t codepoint;
+  std::size_t length;
+};
+
+// Decodes the UTF-8 sequence starting at `index`. Malformed input yields U+FFFD with length 1.
+[[nodiscard]] DecodedCodepoint decode_utf8(std::string_view text, std::size_t index) noexcept;
+
+// Terminal column width of a codepoint: 0 for controls and combining marks, 2 for East Asian
+// wide/fullwidth characters and emoji presentation, 1 otherwise.
+[[nodiscard]] std::size_t codepoint_width(char32_t codepoint) noexcept;
+
+// Column width of UTF-8 text. CSI escape sequences (for example SGR colors) occupy no columns.
+// Runs of printable ASCII are measured 16 (SSE2) or 32 (AVX2) bytes at a time.
+[[nodiscard]] std::size_t display_width(std::string_view text) noexcept;
+
+// Length in bytes of the longest prefix of `text` that fits in `width` columns without splitting
+// a codepoint or an escape sequence.
+[[nodiscard]] std::size_t prefix_bytes_for_width(std::string_view text,
+                                                 std::size_t width) noexcept;
+
+[[nodiscard]] std::string truncate_to_width(std::string_view text, std::size_t width,
+                                            std::string_view ellipsis = "...");
+[[nodiscard]] std::string pad_to_width(std::string_view text, std::size_t width);
+// Truncates with an ellipsis or pads with spaces so the result is exactly `width` columns wide.
+[[nodiscard]] std::string fit_to_width(std::string_view text, std::size_t width,
+                                       std::string_view ellipsis = "...");
+
+} // namespace opentui
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace opentui {
+
+// Bit set of the characters occurring in `text`: one bit per ASCII letter (case-folded) and digit,
+// with all other bytes hashed into the remaining bits. A candidate can only match a pattern whose
+// mask is a subset of its own.
+[[nodiscard]] std::uint64_t character_set_mask(std::string_view text) noexcept;
+
+// fzf-style fuzzy matching: a candidate matches when the pattern's characters occur in it in
+// order. Scores favour consecutive runs and characters at word boundaries (after whitespace,
+// punctuation or a lower-to-upper case change) and penalize gaps, so "stc" ranks "stabilize-ci"
+// above "system-cache". Matching is case-insensitive unless the pattern contains an uppercase
+// letter. Bytes are compared as-is, so only ASCII letters fold.
+class FuzzyMatcher {
+public:
+  explicit FuzzyMatcher(std::string_view pattern);
+
+  [[nodiscard]] bool matches(std::string_view candidate) const noexcept;
+  // nullopt when the candidate does not match, or when its match window is too wide to score at
+  // least `minimum`. An empty pattern matches everything with score 0.
+  [[nodiscard]] std::optional<int>
+  score(std::string_view candidate,
+        int minimum = std::numeric_limits<int>::min()) const noexcept;
+
+  [[nodiscard]] std::string_view pattern() const noexcept;
+  [[nodiscard]] std::uint64_t required_characters() const noexcept;
+  // No candidate scores higher: every character matched at a word start right after whitespace.
+  [[nodiscard]] int best_possible_score() const noexcept;
+
+private:
+  [[nodiscard]] bool same(char pattern_character, char candidate_character) const noexcept;
+
+  std::string pattern_;
+  // The other case of each pattern letter when matching folds case, else the character itself.
+  std::string alternates_;
+  std::uint64_t required_characters_;
+  // Candidate bytes as compared against the pattern: case-folded unless matching is case-sensitive.
+  std::array<char, 256> comparable_{};
+};
+
+struct FuzzyMatch {
+  std::size_t index{0};
+  int score{0};
+};
+
+// Candidates matching `pattern`, best first: higher score, then shorter, then earlier. With an
+// empty pattern every candidate is returned in its original order.
+[[nodiscard]] std::vector<std::string> fuzzy_filter(std::string_view pattern,
+                                                    std::span<const std::string> candidates);
+[[nodiscard]] std::vector<std::string> fuzzy_filter(std::string_view pattern,
+                                                    std::span<const std::string_view> candidates);
+
+// A candidate list prepared for repeated queries, e.g. while the user types. The text is copied
+// into one contiguous buffer and the character-set masks into another, so that a query rejects
+// most candidates several at a time with SIMD compares (AVX2 or SSE2 where available) and scores
+// the rest without chasing a pointer per string. Once the best `limit` matches are known, a
+// candidate that could at most tie them is skipped on its length alone.
+class FuzzyIndex {
+public:
+  FuzzyIndex() = default;
+  explicit FuzzyIndex(std::span<const std::string> candidates);
+
+  void assign(std::span<const std::string> candidates);
+  void add(std::string_view candidate);
+
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] std::string_view operator[](std::size_t index) const;
+
+  // The best `limit` matches, ordered as by fuzzy_filter(). With `matching`, also stores how many
+  // candidates match in all.
+  [[nodiscard]] std::vector<FuzzyMatch> search(std::string_view pattern, std::size_t limit,
+                                               std::size_t* matching = nullptr) const;
+
+private:
+  struct Entry {
+    std::size_t offset;
+    std::size_t length;
+  };
+
+  std::string text_;
+  std::vector<Entry> entries_;
+  std::vector<std::uint64_t> masks_;
+};
+
+} // namespace opentui
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace opentui {
+
+// Editable line with a cursor, stored as text before and after a gap that follows the cursor, so
+// inserting or deleting at the cursor is amortized O(1) however long the line is. text() joins
+// the two halves by moving the gap to the end, which costs O(bytes after the cursor); redrawing
+// reads them where they are through before_gap() and after_gap() instead. Editing at the end of
+// the line never moves anything.
+//
+// The cursor is a byte offset that always sits on a codepoint boundary. Moving it steps over
+// whole characters, including any combining marks that follow them.
+class GapBuffer {
+public:
+  void assign(std::string_view text);
+  void clear() noexcept;
+
+  void insert(std::string_view text);
+  // Deletes the codepoint before the cursor, or the character after it.
+  bool erase_before();
+  bool erase_after();
+
+  bool move_left();
+  bool move_right();
+  void move_home() noexcept;
+  void move_end() noexcept;
+
+  [[nodiscard]] std::size_t cursor() const noexcept;
+  [[nodiscard]] bool cursor_at_end() const noexcept;
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+
+  // Contiguous contents; invalidated by the next edit.
+  [[nodiscard]] std::string_view text();
+  // The contents as the text before and after the gap, which need not be at the cursor;
+  // invalidated by the next edit.
+  [[nodiscard]] std::string_view before_gap() const noexcept;
+  [[nodiscard]] std::string_view after_gap() const noexcept;
+
+private:
+  [[nodiscard]] std::size_t gap_size() const noexcept;
+  [[nodiscard]] std::size_t next_boundary() const noexcept;
+  void move_gap(std::size_t position);
+  void reserve_gap(std::size_t bytes);
+
+  std::vector<char> storage_;
+  std::size_t gap_begin_{0};
+  std::size_t gap_end_{0};
+  std::size_t cursor_{0};
+};
+
+} // namespace opentui
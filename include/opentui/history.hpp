@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/history_index.hpp"
+
+namespace opentui {
+
+// Command history as a fixed-capacity ring whose entries are packed into one byte arena, so
+// adding and evicting are O(1) and entries never own separate allocations.
+//
+// An optional history file keeps entries across sessions. It is an append-only file with one
+// escaped entry per line. Opening it maps the file and scans backwards only far enough to fill the
+// ring, so a file with 100k entries costs no more to open than one with `capacity` entries. Every
+// add() appends one record under an exclusive flock(2) with O_APPEND and first merges whatever
+// other instances appended since the last sync, so concurrent sessions interleave whole entries.
+//
+// Entries are indexed as they are added, so prefix lookups for autosuggestions and substring
+// searches for reverse-i-search stay fast however large the capacity is.
+class History {
+public:
+  static constexpr std::size_t kDefaultCapacity = 1000;
+
+  explicit History(std::size_t capacity = kDefaultCapacity);
+  ~History();
+
+  History(const History&) = delete;
+  History& operator=(const History&) = delete;
+
+  // Loads the newest entries of `path` (created if missing) and appends future entries to it.
+  [[nodiscard]] bool open_file(const std::filesystem::path& path);
+  void close_file() noexcept;
+  [[nodiscard]] bool has_file() const noexcept;
+
+  // Ignores empty lines and immediate repeats of the newest entry.
+  void add(std::string_view line);
+
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] bool empty() const noexcept;
+  [[nodiscard]] std::size_t capacity() const noexcept;
+  // Index 0 is the oldest retained entry. The view is invalidated by the next add().
+  [[nodiscard]] std::string_view operator[](std::size_t index) const;
+  [[nodiscard]] std::string_view back() const;
+
+  // Index of the newest entry that starts with `prefix` and is longer than it.
+  [[nodiscard]] std::optional<std::size_t> newest_extending(std::string_view prefix) const;
+  // Index of the newest entry below `before` that contains `pattern`.
+  [[nodiscard]] std::optional<std::size_t> search_backward(std::string_view pattern,
+                                                           std::size_t before) const;
+
+private:
+  struct Slot {
+    std::size_t offset{0};
+    std::size_t length{0};
+  };
+
+  void store(std::string_view line);
+  void compact();
+  // Stores the newest complete records of `text` (oldest first); returns the bytes consumed.
+  std::size_t load_records(std::string_view text);
+#if !defined(_WIN32)
+  // Loads records other instances appended since the last sync; returns the file size.
+  std::uint64_t merge_appended_records();
+#endif
+
+  std::size_t capacity_;
+  std::vector<Slot> slots_;
+  std::size_t head_{0};
+  std::size_t size_{0};
+  std::vector<char> arena_;
+  std::size_t live_bytes_{0};
+  // Sequence number of the next entry; the oldest retained one is next_sequence_ - size_.
+  std::uint64_t next_sequence_{1};
+  HistoryIndex index_;
+
+  std::filesystem::path path_;
+  int file_descriptor_{-1};
+  std::uint64_t synced_bytes_{0};
+};
+
+} // namespace opentui
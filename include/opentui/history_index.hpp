@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace opentui {
+
+// Search structures over a sliding window of history entries, identified by sequence numbers that
+// increase with every insert. Entries must be evicted oldest first, which keeps both structures
+// exact without rescanning: a radix trie answers prefix queries in O(prefix length) and trigram
+// posting lists narrow substring queries to the entries that can possibly match.
+class HistoryIndex {
+public:
+  using EntryLookup = std::function<std::string_view(std::uint64_t sequence)>;
+
+  HistoryIndex();
+
+  void insert(std::uint64_t sequence, std::string_view entry);
+  // `sequence` must be the oldest indexed entry and `entry` its text.
+  void evict(std::uint64_t sequence, std::string_view entry);
+  void clear();
+
+  // Newest entry that starts with `prefix` and is longer than it.
+  [[nodiscard]] std::optional<std::uint64_t> newest_extending(std::string_view prefix) const;
+  // Newest entry older than `before` that contains `pattern`. Patterns shorter than a trigram are
+  // not indexed and yield nullopt; callers scan for those directly.
+  [[nodiscard]] std::optional<std::uint64_t> newest_containing(std::string_view pattern,
+                                                               std::uint64_t before,
+                                                               const EntryLookup& entry) const;
+
+  static constexpr std::size_t kTrigramLength = 3;
+
+private:
+  static constexpr std::uint32_t kNoNode = 0xFFFFFFFFU;
+
+  struct Node {
+    std::string label;
+    // Newest entry ending at or below this node, and newest one continuing past it; 0 if none.
+    std::uint64_t newest{0};
+    std::uint64_t newest_longer{0};
+    std::vector<std::uint32_t> children;
+  };
+
+  struct Postings {
+    std::vector<std::uint64_t> sequences;
+    std::size_t start{0};
+  };
+
+  [[nodiscard]] std::uint32_t find_child(std::uint32_t node, char first) const;
+  [[nodiscard]] std::uint32_t allocate_node(std::string_view label, std::uint64_t sequence);
+  void release_subtree(std::uint32_t node);
+
+  std::vector<Node> nodes_;
+  std::vector<std::uint32_t> free_nodes_;
+  std::unordered_map<std::uint32_t, Postings> trigrams_;
+};
+
+} // namespace opentui
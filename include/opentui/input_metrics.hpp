@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace opentui {
+
+// Set by the OPEN_TUI_INPUT_METRICS CMake option. When it is off every timestamp and record call
+// below compiles to nothing.
+#if defined(OPEN_TUI_INPUT_METRICS)
+inline constexpr bool kInputMetricsEnabled = true;
+#else
+inline constexpr bool kInputMetricsEnabled = false;
+#endif
+
+// Steps between a key arriving and its frame reaching the terminal.
+enum class InputStage : std::uint8_t {
+  // Turning buffered input into one key event.
+  Decode,
+  // Getting current candidates, including waiting for the completion worker up to the deadline.
+  Completion,
+  Autosuggestion,
+  FrameBuild,
+  // Handing the frame to the console and flushing it.
+  Write,
+  // From read(2) returning with the keys to the end of the write of the frame they produced.
+  KeyToPaint,
+};
+
+inline constexpr std::size_t kInputStageCount = 6;
+
+[[nodiscard]] std::string_view input_stage_name(InputStage stage) noexcept;
+
+// Latency distribution in power-of-two nanosecond buckets: bucket n counts values below 2^n and
+// at least 2^(n-1). Samples are recorded by one thread at a time (the input thread) with relaxed
+// atomic loads and stores, so recording never locks or waits, and any thread may take a snapshot.
+class LatencyHistogram {
+public:
+  static constexpr std::size_t kBuckets = 40;
+
+  struct Snapshot {
+    std::array<std::uint64_t, kBuckets> buckets{};
+    std::uint64_t count{0};
+    std::uint64_t total_nanoseconds{0};
+    std::uint64_t max_nanoseconds{0};
+
+    // Upper bound of the bucket holding the given fraction (0..1] of the samples.
+    [[nodiscard]] std::uint64_t percentile_nanoseconds(double fraction) const noexcept;
+    [[nodiscard]] std::uint64_t mean_nanoseconds() const noexcept;
+  };
+
+  void record(std::uint64_t nanoseconds) noexcept;
+  [[nodiscard]] Snapshot snapshot() const noexcept;
+  void reset() noexcept;
+
+  [[nodiscard]] static std::uint64_t bucket_upper_bound(std::size_t bucket) noexcept;
+
+private:
+  std::array<std::atomic<std::uint64_t>, kBuckets> buckets_{};
+  std::atomic<std::uint64_t> total_nanoseconds_{0};
+  std::atomic<std::uint64_t> max_nanoseconds_{0};
+};
+
+// Per-stage latency histograms for the interactive input path.
+class InputMetrics {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  // The current time, or a constant when metrics are compiled out.
+  [[nodiscard]] static Clock::time_point now() noexcept {
+    if constexpr (kInputMetricsEnabled) {
+      return Clock::now();
+    } else {
+      return {};
+    }
+  }
+
+  void record_since(const InputStage stage, const Clock::time_point start) noexcept {
+    if constexpr (kInputMetricsEnabled) {
+      record(stage, Clock::now() - start);
+    } else {
+      static_cast<void>(stage);
+      static_cast<void>(start);
+    }
+  }
+
+  void record(InputStage stage, Clock::duration elapsed) noexcept;
+  [[nodiscard]] const LatencyHistogram& histogram(InputStage stage) const noexcept;
+  void reset() noexcept;
+
+  // A header line, then one line per stage with sample count, mean, p50, p90, p99 and maximum.
+  [[nodiscard]] std::string report() const;
+  // Writes every non-empty bucket as CSV rows of stage, bucket upper bound in ns and count.
+  [[nodiscard]] bool export_csv(const std::filesystem::path& path) const;
+
+private:
+  std::array<LatencyHistogram, kInputStageCount> histograms_;
+};
+
+// Records the time from construction to stop() or destruction against `stage`. A null `metrics`
+// records nothing.
+class StageTimer {
+public:
+  StageTimer(InputMetrics* metrics, const InputStage stage) noexcept
+      : metrics_(metrics), stage_(stage), start_(InputMetrics::now()) {}
+
+  ~StageTimer() {
+    stop();
+  }
+
+  StageTimer(const StageTimer&) = delete;
+  StageTimer& operator=(const StageTimer&) = delete;
+
+  void stop() noexcept {
+    if constexpr (kInputMetricsEnabled) {
+      if (metrics_ != nullptr) {
+        metrics_->record_since(stage_, start_);
+        metrics_ = nullptr;
+      }
+    }
+  }
+
+private:
+  InputMetrics* metrics_;
+  InputStage stage_;
+  InputMetrics::Clock::time_point start_;
+};
+
+} // namespace opentui
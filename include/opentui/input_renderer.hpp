@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/input_metrics.hpp"
+
+namespace opentui {
+
+class Console;
+
+struct InputFrame {
+  std::string_view prompt{};
+  // The line is `buffer` followed by `buffer_tail`, so a caller holding it in two pieces, as
+  // GapBuffer does, need not join them to draw it. The split must fall between codepoints.
+  std::string_view buffer{};
+  std::string_view buffer_tail{};
+  // Full suggested line; the part after the line is drawn as dim ghost text.
+  std::string_view autosuggestion{};
+  // Shown on the rows below the input line, one row each.
+  std::span<const std::string> completion_rows{};
+  // Byte offset of the cursor in the line; npos places it at the end.
+  std::size_t cursor{std::string_view::npos};
+};
+
+// Renders the interactive input line. The renderer remembers what it last put on screen and sends
+// only the difference: typing at the end of the line emits the new characters plus whatever part
+// of the ghost text or completion rows changed, an edit in the middle rewrites the line from the
+// edit onwards, and moving the cursor emits only the motion. The prompt is repainted only when
+// the on-screen state is unknown (first frame, after clear()/commit()) or the prompt itself
+// changed. Each frame is written with a single flush, wrapped in a synchronized update (DEC mode
+// 2026) when the terminal supports it.
+//
+// Once the terminal width is known, nothing drawn wraps. A line too wide for its row shows the
+// part around the cursor, scrolled by half a row whenever the cursor would leave it, so the work
+// per frame is bounded by the width rather than the length of the line. Completion rows are cut
+// at the edge.
+class InputRenderer {
+public:
+  explicit InputRenderer(Console& console);
+
+  // Terminal width in columns; 0, the default, draws everything unclipped.
+  void set_columns(std::size_t columns) noexcept;
+  [[nodiscard]] std::size_t columns() const noexcept;
+
+  void set_synchronized_output(bool enabled) noexcept;
+  [[nodiscard]] bool synchronized_output() const noexcept;
+  // Frame build and write times of render() are recorded here; null records nothing.
+  void set_metrics(InputMetrics* metrics) noexcept;
+
+  void render(const InputFrame& frame);
+  // Draws the final state of the line and moves to a fresh row below it.
+  void commit(std::string_view prompt, std::string_view buffer);
+  // Erases the input and completion rows without flushing, e.g. before printing above the prompt.
+  void clear();
+  // Forgets the on-screen state so the next frame repaints the whole line.
+  void invalidate() noexcept;
+
+  [[nodiscard]] std::size_t last_frame_bytes() const noexcept;
+
+private:
+  // What a frame puts on the input row after the prompt: the visible part of the line, in two
+  // pieces like InputFrame's, and of the ghost text after it.
+  struct Row {
+    std::string_view head{};
+    std::string_view tail{};
+    std::string_view ghost{};
+  };
+
+  void begin_frame();
+  void end_frame();
+  void build(const InputFrame& frame);
+  // Both return the column the terminal cursor is left in.
+  std::size_t build_full(std::string_view prompt, const Row& row);
+  std::size_t build_incremental(const Row& row);
+  void update_completion_rows(std::span<const std::string> rows, std::size_t& column);
+
+  Console& console_;
+  InputMetrics* metrics_{nullptr};
+  std::string frame_;
+  std::size_t frame_prefix_{0};
+  bool synchronized_output_;
+  std::size_t columns_{0};
+  std::vector<std::string> fitted_rows_;
+
+  bool shown_valid_{false};
+  std::string shown_prompt_;
+  // Byte offset in the line of the first byte shown, and what is shown from there.
+  std::size_t shown_start_{0};
+  std::string shown_buffer_;
+  std::string shown_ghost_;
+  std::vector<std::string> shown_completion_rows_;
+  std::size_t shown_cursor_column_{0};
+};
+
+} // namespace opentui
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "opentui/command_registry.hpp"
+
+namespace opentui {
+
+class Console;
+
+enum class JobState : std::uint8_t {
+  Running,
+  Done,
+  Failed,
+  Cancelled,
+};
+
+[[nodiscard]] std::string_view job_state_name(JobState state) noexcept;
+// "[id] text", or "[id] status  text" when a status is given.
+[[nodiscard]] std::string job_line(std::size_t id, std::string_view status, std::string_view text);
+
+struct JobInfo {
+  std::size_t id{0};
+  std::string command;
+  JobState state{JobState::Running};
+};
+
+// Runs command tasks on their own threads while the prompt stays live. Each job's task gets a
+// CommandContext whose stop_token is signalled by cancel() or stop_all(); its output goes through
+// Console::post(), and a "[id] Done" (or Failed, or Cancelled) line is posted when it returns.
+// Everything except the tasks themselves runs on the input thread.
+class JobManager {
+public:
+  explicit JobManager(Console& console);
+  // Cancels and joins every job.
+  ~JobManager();
+
+  JobManager(const JobManager&) = delete;
+  JobManager& operator=(const JobManager&) = delete;
+
+  // Starts `task` in the background, sharing `context`'s running flag, and returns the job id.
+  // Finished jobs are forgotten first.
+  std::size_t start(std::string command, CommandTask task, const CommandContext& context);
+
+  // Every job, oldest first; finished ones are listed once more and then forgotten.
+  [[nodiscard]] std::vector<JobInfo> take_jobs();
+  // The newest job still running.
+  [[nodiscard]] std::optional<std::size_t> latest_running() const;
+
+  // Requests cancellation. Returns false if no running job has that id.
+  bool cancel(std::size_t id);
+  // Waits for a job in the foreground, printing posted output as it arrives. `interrupted` is
+  // polled while waiting; when it returns true the job is cancelled and still waited for. Returns
+  // the final state, or nothing if no job has that id.
+  std::optional<JobState> wait(std::size_t id, const std::function<bool()>& interrupted);
+  // Cancels every job and waits for all of them to return.
+  void stop_all();
+
+  [[nodiscard]] std::size_t running() const;
+
+private:
+  static constexpr std::chrono::milliseconds kWaitPollInterval{50};
+
+  struct Job {
+    std::size_t id{0};
+    std::string command;
+    std::atomic<JobState> state{JobState::Running};
+    std::jthread thread;
+  };
+
+  [[nodiscard]] Job* find(std::size_t id) const;
+  void finish(Job& job, JobState state);
+  void forget_finished();
+
+  Console& console_;
+  std::vector<std::unique_ptr<Job>> jobs_;
+  std::size_t next_id_{1};
+  std::mutex mutex_;
+  std::condition_variable finished_;
+};
+
+} // namespace opentui
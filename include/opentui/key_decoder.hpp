@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace opentui {
+
+enum class KeyCode {
+  // A run of printable characters (UTF-8), coalesced across one read.
+  Text,
+  // The contents of a bracketed paste, delivered as a single event.
+  Paste,
+  Enter,
+  Tab,
+  BackTab,
+  Backspace,
+  Delete,
+  Escape,
+  Up,
+  Down,
+  Left,
+  Right,
+  Home,
+  End,
+  PageUp,
+  PageDown,
+  Insert,
+  // Ctrl+letter; KeyEvent::control holds the lowercase letter.
+  Control,
+  // A recognized but unsupported escape sequence, consumed whole.
+  Unknown,
+};
+
+struct KeyEvent {
+  KeyCode code{KeyCode::Unknown};
+  // Text and Paste payload. Points into the decoder; valid until the next feed() or next().
+  std::string_view text{};
+  char control{'\0'};
+};
+
+// Turns raw terminal input into key events. Bytes are fed in whatever chunks read(2) returned;
+// CSI and SS3 sequences are parsed with a state machine that tolerates sequences split across
+// reads, and bracketed paste (ESC[200~ ... ESC[201~) is collected into one Paste event.
+class KeyDecoder {
+public:
+  static constexpr std::string_view kEnableBracketedPaste = "\033[?2004h";
+  static constexpr std::string_view kDisableBracketedPaste = "\033[?2004l";
+
+  void feed(std::string_view bytes);
+  // Returns the next complete event, or std::nullopt when more input is needed.
+  [[nodiscard]] std::optional<KeyEvent> next();
+
+  // True when the only buffered input is an ESC that may still start a sequence. If no further
+  // byte arrives within the caller's escape timeout, take_escape() reports it as a lone Escape.
+  [[nodiscard]] bool escape_pending() const noexcept;
+  [[nodiscard]] std::optional<KeyEvent> take_escape();
+
+  [[nodiscard]] bool in_paste() const noexcept;
+
+private:
+  enum class Sequence { Complete, Incomplete };
+
+  [[nodiscard]] std::optional<KeyEvent> next_in_paste();
+  [[nodiscard]] Sequence decode_escape(KeyEvent& event);
+  // Returns an empty Text event when the run so far is an incomplete UTF-8 sequence.
+  [[nodiscard]] KeyEvent decode_text();
+
+  std::string input_;
+  std::size_t position_{0};
+  std::string paste_;
+  bool in_paste_{false};
+  bool paste_delivered_{false};
+};
+
+} // namespace opentui
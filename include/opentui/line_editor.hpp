@@ -1,26 +1,74 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
+#include <filesystem>
 #include <functional>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
 
+#include "opentui/completion_menu.hpp"
+#include "opentui/completion_worker.hpp"
+#include "opentui/history.hpp"
+#include "opentui/input_metrics.hpp"
+#include "opentui/input_renderer.hpp"
+#include "opentui/key_decoder.hpp"
+
 namespace opentui {
 
+class Console;
+
 class LineEditor {
 public:
-  using CompletionProvider = std::function<std::vector<std::string>(std::string_view)>;
+  // Returns every candidate for the buffer.
+  using CompletionProvider = std::function<std::vector<std::string>(std::string_view buffer)>;
+  // Returns a page of the candidates for the buffer, so long lists are fetched as they are shown.
+  using CompletionPageProvider = CompletionWorker::Provider;
+
+  // Completion providers run on a worker thread. A redraw waits at most this long for fresh
+  // candidates before showing the last good ones; late results are drawn when they arrive.
+  static constexpr std::chrono::milliseconds kDefaultCompletionDeadline{30};
+  // Tab needs current candidates, so it waits longer before giving up with a bell.
+  static constexpr std::chrono::milliseconds kTabCompletionTimeout{1000};
+  // Candidates asked of a page provider at a time; the next page is asked for as the menu nears
+  // the end of those loaded.
+  static constexpr std::size_t kCompletionPageSize = 256;
+  // Tab fetches the rest of lists up to this long to expand the line to their common prefix; it
+  // only opens the menu for longer ones.
+  static constexpr std::size_t kMaxTabCandidates = 4096;
+
+  explicit LineEditor(Console& console);
 
   [[nodiscard]] std::optional<std::string> read_line(std::string_view prompt,
                                                      const CompletionProvider& completion_provider);
+  [[nodiscard]] std::optional<std::string>
+  read_line(std::string_view prompt, const CompletionPageProvider& completion_provider);
+
+  void set_completion_deadline(std::chrono::milliseconds deadline) noexcept;
+  // Candidate rows shown below the input line; a position row is added when more are available.
+  void set_completion_menu_height(std::size_t rows) noexcept;
+
+  // Persists history to `path`, loading the entries already stored there.
+  [[nodiscard]] bool set_history_file(const std::filesystem::path& path);
+  [[nodiscard]] History& history() noexcept;
+
+  // Stage latencies of interactive input; empty unless built with OPEN_TUI_INPUT_METRICS.
+  [[nodiscard]] InputMetrics& input_metrics() noexcept;
 
 private:
   [[nodiscard]] static bool is_interactive();
 
-  static constexpr std::size_t kMaxHistoryEntries = 256;
-  std::vector<std::string> history_;
+  Console& console_;
+  InputMetrics metrics_;
+  InputRenderer renderer_;
+  // Outlives read_line() so keys typed ahead of the next prompt are not lost.
+  KeyDecoder decoder_;
+  CompletionWorker completion_worker_;
+  std::chrono::milliseconds completion_deadline_{kDefaultCompletionDeadline};
+  std::size_t completion_menu_height_{CompletionMenu::kDefaultHeight};
+  History history_;
 };
 
 } // namespace opentui
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace opentui {
+
+// Unbounded lock-free multi-producer/single-consumer queue (Vyukov's node-based design).
+// push() is wait-free and may be called from any thread; pop() must only be called by the single
+// owning consumer. A pop() racing an in-flight push() may report empty; the pushed value becomes
+// visible once that push() returns.
+template <typename T> class MpscQueue {
+public:
+  MpscQueue() = default;
+
+  ~MpscQueue() {
+    while (pop().has_value()) {
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  void push(T value) {
+    push_node(new Node{.next = nullptr, .value = std::move(value)});
+  }
+
+  [[nodiscard]] std::optional<T> pop() {
+    Node* tail = tail_;
+    Node* next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return std::nullopt;
+      }
+      tail_ = next;
+      tail = next;
+      next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+      tail_ = next;
+      return take(tail);
+    }
+
+    if (tail != head_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+
+    stub_.next.store(nullptr, std::memory_order_relaxed);
+    push_node(&stub_);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return std::nullopt;
+    }
+
+    tail_ = next;
+    return take(tail);
+  }
+
+private:
+  struct Node {
+    std::atomic<Node*> next{nullptr};
+    T value{};
+  };
+
+  void push_node(Node* node) {
+    Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+  }
+
+  [[nodiscard]] static std::optional<T> take(Node* node) {
+    std::optional<T> value{std::move(node->value)};
+    delete node;
+    return value;
+  }
+
+  Node stub_{};
+  std::atomic<Node*> head_{&stub_};
+  Node* tail_{&stub_};
+};
+
+} // namespace opentui
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace opentui {
+
+class AsyncWriter;
+
+struct OutputStats {
+  std::uint64_t write_calls{0};
+  // Bytes written to the file descriptor, by this buffer or by async writers since detached.
+  std::uint64_t bytes_written{0};
+  std::uint64_t flushes{0};
+  // Bytes queued on async writers instead, and those of them the writers then dropped.
+  std::uint64_t bytes_handed_off{0};
+  std::uint64_t bytes_dropped{0};
+};
+
+// Collects everything written during a frame into one contiguous buffer and hands it to the
+// file descriptor with a single write(2)/writev(2) on flush() or when the high watermark is hit.
+class OutputBuffer {
+public:
+  static constexpr int kStandardOutput = 1;
+  static constexpr std::size_t kDefaultHighWatermark = 64U * 1024U;
+
+  explicit OutputBuffer(int file_descriptor = kStandardOutput,
+                        std::size_t high_watermark = kDefaultHighWatermark);
+  ~OutputBuffer();
+
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+  void append(std::string_view text);
+  void append(char character);
+  void flush();
+
+  void set_high_watermark(std::size_t bytes) noexcept;
+  [[nodiscard]] std::size_t high_watermark() const noexcept;
+
+  // While a writer is attached, flushed frames are handed to its thread instead of being written
+  // on the calling thread. The writer must outlive the attachment. Replacing a writer waits for it
+  // to finish what it was handed and adds what it wrote and dropped to stats().
+  void set_async_writer(AsyncWriter* writer);
+
+  [[nodiscard]] std::string_view pending() const noexcept;
+  [[nodiscard]] const OutputStats& stats() const noexcept;
+
+private:
+  void write_segments(std::string_view first, std::string_view second = {});
+  void hand_off();
+
+  int file_descriptor_;
+  std::size_t high_watermark_;
+  std::string buffer_;
+  OutputStats stats_;
+  AsyncWriter* async_writer_{nullptr};
+};
+
+} // namespace opentui
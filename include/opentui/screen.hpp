@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "opentui/style.hpp"
+
+namespace opentui {
+
+class Console;
+
+struct Cell {
+  char32_t glyph{U' '};
+  Style style{};
+  // Columns occupied by the glyph; 0 marks the trailing half of a wide glyph.
+  std::uint8_t width{1};
+
+  friend bool operator==(const Cell&, const Cell&) = default;
+};
+
+// Double-buffered cell grid. Applications draw into the back buffer and present() emits only the
+// cells that differ from what is already on screen, using the cheapest cursor motion and the
+// fewest SGR changes it can find.
+class Screen {
+public:
+  Screen(std::size_t width, std::size_t height);
+
+  void resize(std::size_t width, std::size_t height);
+  [[nodiscard]] std::size_t width() const noexcept;
+  [[nodiscard]] std::size_t height() const noexcept;
+
+  void clear(Style style = {});
+  void put(std::size_t column, std::size_t row, char32_t glyph, Style style = {});
+  std::size_t draw_text(std::size_t column, std::size_t row, std::string_view text,
+                        Style style = {});
+  void fill(std::size_t column, std::size_t row, std::size_t width, std::size_t height,
+            char32_t glyph, Style style = {});
+
+  [[nodiscard]] const Cell& at(std::size_t column, std::size_t row) const;
+
+  // Forgets what is on screen so the next present() repaints every cell.
+  void invalidate() noexcept;
+  void present(Console& console);
+
+  [[nodiscard]] std::size_t last_frame_bytes() const noexcept;
+
+private:
+  [[nodiscard]] std::size_t offset(std::size_t column, std::size_t row) const noexcept;
+  void release_cell(std::size_t column, std::size_t row);
+  void move_cursor(std::size_t column, std::size_t row);
+  void set_style(Style style);
+  void emit_cell(const Cell& cell);
+
+  std::size_t width_;
+  std::size_t height_;
+  std::vector<Cell> front_;
+  std::vector<Cell> back_;
+  std::string frame_;
+
+  bool full_repaint_{true};
+  bool cursor_known_{false};
+  std::size_t cursor_column_{0};
+  std::size_t cursor_row_{0};
+  Style current_style_{};
+};
+
+} // namespace opentui
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace opentui {
+
+struct ScrollbackMatch {
+  std::uint64_t line_number;
+  std::string_view text;
+};
+
+// Bounded in-process scrollback. Lines are packed back to back into fixed-size chunks with a
+// per-chunk line-offset index; once the memory cap is exceeded whole chunks are evicted oldest
+// first. Line numbers are monotonic over the lifetime of the store and survive eviction.
+class Scrollback {
+public:
+  static constexpr std::size_t kDefaultMemoryLimit = 64U * 1024U * 1024U;
+  static constexpr std::size_t kChunkSize = 256U * 1024U;
+
+  explicit Scrollback(std::size_t memory_limit = kDefaultMemoryLimit);
+
+  // Appends raw text; newline characters terminate lines and a trailing fragment is kept until
+  // its line is completed.
+  void append(std::string_view text);
+  void append_line(std::string_view line);
+  void clear();
+
+  [[nodiscard]] std::uint64_t first_line_number() const noexcept;
+  [[nodiscard]] std::uint64_t end_line_number() const noexcept;
+  [[nodiscard]] std::size_t size() const noexcept;
+  [[nodiscard]] std::size_t memory_usage() const noexcept;
+  [[nodiscard]] std::size_t memory_limit() const noexcept;
+
+  // Returns the retained line, or an empty view when it has been evicted or not written yet.
+  [[nodiscard]] std::string_view line(std::uint64_t line_number) const;
+
+  // Newest-first search for lines containing `needle`; stops after `limit` matches.
+  [[nodiscard]] std::vector<ScrollbackMatch> find(std::string_view needle,
+                                                  std::size_t limit) const;
+
+private:
+  struct Chunk {
+    std::vector<char> data;
+    std::size_t used{0};
+    std::uint64_t first_line{0};
+    // End offset (exclusive of the separating newline) of every line stored in the chunk.
+    std::vector<std::uint32_t> line_ends;
+  };
+
+  [[nodiscard]] Chunk& chunk_for(std::size_t bytes);
+  [[nodiscard]] std::string_view line_in(const Chunk& chunk, std::size_t index) const;
+  void store_line(std::string_view line);
+  void enforce_limit();
+
+  std::size_t memory_limit_;
+  std::size_t memory_usage_{0};
+  std::uint64_t next_line_{0};
+  std::deque<Chunk> chunks_;
+  std::string partial_;
+};
+
+} // namespace opentui
@@ -17,6 +17,9 @@ public:
 
   static void request_stop() noexcept;
   static void clear_stop() noexcept;
+  // Clears a pending stop request, returning whether there was one. Lets a foreground wait treat
+  // Ctrl-C as "cancel this" rather than "exit".
+  static bool take_stop() noexcept;
 
 private:
   using SignalHandler = void (*)(int);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace opentui {
+
+enum class Color {
+  Default = -1,
+  Black = 0,
+  Red = 1,
+  Green = 2,
+  Yellow = 3,
+  Blue = 4,
+  Magenta = 5,
+  Cyan = 6,
+  White = 7,
+  BrightBlack = 8,
+  BrightRed = 9,
+  BrightGreen = 10,
+  BrightYellow = 11,
+  BrightBlue = 12,
+  BrightMagenta = 13,
+  BrightCyan = 14,
+  BrightWhite = 15,
+};
+
+// Interned foreground/background/bold combination. The handle is a dense index into a table of
+// SGR escape sequences generated at compile time, so resolving its prefix never allocates.
+class Style {
+public:
+  static constexpr std::size_t kColorSlots = 17;
+  static constexpr std::size_t kCount = kColorSlots * kColorSlots * 2U;
+
+  constexpr Style() noexcept = default;
+
+  constexpr Style(const Color foreground, const Color background = Color::Default,
+                  const bool bold = false) noexcept
+      : index_(static_cast<std::uint16_t>((bold ? kColorSlots * kColorSlots : 0U) +
+                                          (slot(foreground) * kColorSlots) + slot(background))) {}
+
+  [[nodiscard]] constexpr Color foreground() const noexcept {
+    return color_for((index_ % (kColorSlots * kColorSlots)) / kColorSlots);
+  }
+
+  [[nodiscard]] constexpr Color background() const noexcept {
+    return color_for(index_ % kColorSlots);
+  }
+
+  [[nodiscard]] constexpr bool bold() const noexcept {
+    return index_ >= kColorSlots * kColorSlots;
+  }
+
+  [[nodiscard]] constexpr bool plain() const noexcept {
+    return index_ == 0U;
+  }
+
+  [[nodiscard]] constexpr std::size_t index() const noexcept {
+    return index_;
+  }
+
+  // Escape sequence that switches the terminal into this style; empty for the plain style.
+  [[nodiscard]] std::string_view prefix() const noexcept;
+
+  // Escape sequence that returns the terminal to the plain style.
+  [[nodiscard]] static constexpr std::string_view reset() noexcept {
+    return "\033[0m";
+  }
+
+  friend constexpr bool operator==(Style, Style) noexcept = default;
+
+private:
+  [[nodiscard]] static constexpr std::size_t slot(const Color color) noexcept {
+    const int value = static_cast<int>(color);
+    return (value < 0 || value >= static_cast<int>(kColorSlots) - 1)
+               ? 0U
+               : static_cast<std::size_t>(value) + 1U;
+  }
+
+  [[nodiscard]] static constexpr Color color_for(const std::size_t slot_index) noexcept {
+    return static_cast<Color>(static_cast<int>(slot_index) - 1);
+  }
+
+  std::uint16_t index_{0};
+};
+
+} // namespace opentui
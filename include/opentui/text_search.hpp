@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace opentui {
+
+// Substring search that compares 16 candidate positions per step with SSE2 (first and last needle
+// byte filter) where available and falls back to std::string_view::find elsewhere.
+// Returns std::string_view::npos when `needle` does not occur at or after `from`.
+[[nodiscard]] std::size_t find_substring(std::string_view haystack, std::string_view needle,
+                                         std::size_t from = 0) noexcept;
+
+} // namespace opentui
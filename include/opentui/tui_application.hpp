@@ -1,10 +1,13 @@
 #pragma once
 
 #include <atomic>
+#include <filesystem>
+#include <iosfwd>
 #include <string>
 
 #include "opentui/command_registry.hpp"
 #include "opentui/console.hpp"
+#include "opentui/job_manager.hpp"
 #include "opentui/line_editor.hpp"
 
 namespace opentui {
@@ -14,10 +17,19 @@ public:
   virtual ~TuiApplication() = default;
 
   int run();
+  // With `--batch`, runs the commands read from standard input through run_script(); with
+  // `--stop-on-error` as well, stops at the first failing one. Otherwise runs interactively.
+  int run(int argc, const char* const* argv);
+  // Runs every line of `input` as a command, without the banner, prompt, scrollback or
+  // start/shutdown hooks, flushing output once per chunk read. Returns 0 when every command
+  // succeeded and 1 otherwise, after listing the failing lines on standard error.
+  int run_script(std::istream& input, const ScriptOptions& options = {});
 
 protected:
   [[nodiscard]] virtual std::string banner() const;
   [[nodiscard]] virtual std::string prompt() const;
+  // Where command history persists between sessions; an empty path keeps it in memory only.
+  [[nodiscard]] virtual std::filesystem::path history_file() const;
 
   virtual void on_start(Console& console);
   virtual void on_shutdown(Console& console);
@@ -27,11 +39,14 @@ protected:
   Console& console() noexcept;
 
 private:
+  void reset_commands();
   void register_builtin_commands();
 
   CommandRegistry command_registry_;
+  CompletionCache completion_cache_;
   Console console_;
-  LineEditor line_editor_;
+  LineEditor line_editor_{console_};
+  JobManager jobs_{console_};
   std::atomic_bool running_{true};
 };
 
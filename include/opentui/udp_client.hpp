@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <optional>
 #include <string>
+#include <stop_token>
 #include <string_view>
 
 namespace opentui {
@@ -22,6 +23,14 @@ public:
   [[nodiscard]] std::optional<std::string> receive_once(std::uint16_t local_port,
                                                         std::chrono::milliseconds timeout,
                                                         std::string* error = nullptr) const;
+  // As above, but gives up early once `stop_token` is signalled, checking it every
+  // kStopPollInterval.
+  [[nodiscard]] std::optional<std::string> receive_once(std::uint16_t local_port,
+                                                        std::chrono::milliseconds timeout,
+                                                        std::stop_token stop_token,
+                                                        std::string* error = nullptr) const;
+
+  static constexpr std::chrono::milliseconds kStopPollInterval{100};
 
 private:
   static void set_error(std::string* error, std::string_view message);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <atomic>
+
+namespace opentui {
+
+// Lets any thread wake a consumer that is blocked waiting for terminal input. On POSIX this is a
+// non-blocking self-pipe whose read end can be handed to poll(2); notify() never blocks.
+class WakeupSignal {
+public:
+  WakeupSignal();
+  ~WakeupSignal();
+
+  WakeupSignal(const WakeupSignal&) = delete;
+  WakeupSignal& operator=(const WakeupSignal&) = delete;
+
+  void notify() noexcept;
+  // Consumes pending notifications. Returns true if at least one was pending.
+  bool consume() noexcept;
+  [[nodiscard]] bool pending() const noexcept;
+
+  // Read end of the self-pipe for poll(2), or -1 where unavailable.
+  [[nodiscard]] int native_handle() const noexcept;
+
+private:
+  std::atomic_bool pending_{false};
+  int read_fd_{-1};
+  int write_fd_{-1};
+};
+
+} // namespace opentui
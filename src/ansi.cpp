@@ -0,0 +1,140 @@
+#include "opentui/ansi.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace opentui::ansi {
+namespace {
+
+[[nodiscard]] std::size_t decimal_digits(std::size_t value) noexcept {
+  std::size_t digits = 1;
+  while (value >= 10U) {
+    value /= 10U;
+    ++digits;
+  }
+  return digits;
+}
+
+[[nodiscard]] std::string_view environment(const char* name) {
+  const char* value = std::getenv(name);
+  return value == nullptr ? std::string_view{} : std::string_view{value};
+}
+
+} // namespace
+
+void append_number(std::string& output, const std::size_t value) {
+  std::array<char, 24> digits{};
+  const auto [end, error] = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+  static_cast<void>(error);
+  output.append(digits.data(), end);
+}
+
+std::size_t cursor_sequence_length(const std::size_t count) noexcept {
+  return 3U + (count == 1U ? 0U : decimal_digits(count));
+}
+
+void append_cursor_sequence(std::string& output, const std::size_t count, const char final_byte) {
+  output.append("\033[");
+  if (count != 1U) {
+    append_number(output, count);
+  }
+  output.push_back(final_byte);
+}
+
+std::size_t absolute_move_length(const std::size_t row, const std::size_t column) noexcept {
+  if (row == 0U && column == 0U) {
+    return 3U;
+  }
+  return 4U + decimal_digits(row + 1U) + decimal_digits(column + 1U);
+}
+
+void append_absolute_move(std::string& output, const std::size_t row, const std::size_t column) {
+  output.append("\033[");
+  if (row != 0U || column != 0U) {
+    append_number(output, row + 1U);
+    output.push_back(';');
+    append_number(output, column + 1U);
+  }
+  output.push_back('H');
+}
+
+std::size_t horizontal_move_length(const std::size_t from, const std::size_t to) noexcept {
+  if (from == to) {
+    return 0U;
+  }
+  const std::size_t carriage_return = 1U + (to == 0U ? 0U : cursor_sequence_length(to));
+  if (to > from) {
+    return std::min(cursor_sequence_length(to - from), carriage_return);
+  }
+  // Backspace moves one column left in a single byte.
+  return std::min({cursor_sequence_length(from - to), carriage_return, from - to});
+}
+
+void append_horizontal_move(std::string& output, const std::size_t from, const std::size_t to) {
+  if (from == to) {
+    return;
+  }
+
+  const std::size_t relative = cursor_sequence_length(to > from ? to - from : from - to);
+  const std::size_t carriage_return = 1U + (to == 0U ? 0U : cursor_sequence_length(to));
+  if (to < from && from - to < std::min(relative, carriage_return)) {
+    output.append(from - to, '\b');
+    return;
+  }
+  if (relative < carriage_return) {
+    append_cursor_sequence(output, to > from ? to - from : from - to, to > from ? 'C' : 'D');
+    return;
+  }
+
+  output.push_back('\r');
+  if (to != 0U) {
+    append_cursor_sequence(output, to, 'C');
+  }
+}
+
+bool terminal_supports_synchronized_output() {
+  const std::string_view override_value = environment("OPEN_TUI_SYNC_OUTPUT");
+  if (!override_value.empty()) {
+    return override_value != "0";
+  }
+
+  const std::string_view program = environment("TERM_PROGRAM");
+  constexpr std::array<std::string_view, 7> kPrograms{
+      "iTerm.app", "WezTerm", "vscode", "ghostty", "contour", "Tabby", "rio"};
+  if (std::ranges::find(kPrograms, program) != kPrograms.end()) {
+    return true;
+  }
+
+  const std::string_view term = environment("TERM");
+  constexpr std::array<std::string_view, 6> kTerms{"kitty",   "foot",  "alacritty",
+                                                   "wezterm", "ghostty", "contour"};
+  return std::ranges::any_of(
+      kTerms, [term](std::string_view name) { return term.find(name) != std::string_view::npos; });
+}
+
+std::size_t terminal_columns() noexcept {
+#if defined(_WIN32)
+  CONSOLE_SCREEN_BUFFER_INFO info{};
+  if (GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info) == 0) {
+    return 0;
+  }
+  return static_cast<std::size_t>(info.srWindow.Right - info.srWindow.Left + 1);
+#else
+  winsize size{};
+  if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) {
+    return 0;
+  }
+  return size.ws_col;
+#endif
+}
+
+} // namespace opentui::ansi
@@ -0,0 +1,166 @@
+#include "opentui/async_writer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <string_view>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace opentui {
+
+AsyncWriter::AsyncWriter(const int file_descriptor, const AsyncWriterOptions options)
+    : file_descriptor_(file_descriptor), options_(options) {
+  options_.max_queued_bytes = std::max<std::size_t>(options_.max_queued_bytes, 1U);
+  thread_ = std::thread([this]() { run(); });
+}
+
+AsyncWriter::~AsyncWriter() {
+  {
+    const std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  queue_not_empty_.notify_one();
+  thread_.join();
+}
+
+void AsyncWriter::submit(std::string buffer) {
+  if (buffer.empty()) {
+    return;
+  }
+
+  std::unique_lock lock(mutex_);
+  const auto has_room = [this, &buffer]() {
+    return queue_.empty() || queued_bytes_ + buffer.size() <= options_.max_queued_bytes;
+  };
+
+  if (options_.policy == BackpressurePolicy::Block) {
+    if (!has_room()) {
+      ++stats_.producer_waits;
+      queue_not_full_.wait(lock, has_room);
+    }
+  } else {
+    while (!has_room()) {
+      std::string& oldest = queue_.front();
+      queued_bytes_ -= oldest.size();
+      ++stats_.buffers_dropped;
+      bytes_dropped_.fetch_add(oldest.size(), std::memory_order_relaxed);
+      if (options_.policy == BackpressurePolicy::Summarize) {
+        dropped_lines_ += static_cast<std::uint64_t>(std::ranges::count(oldest, '\n'));
+      }
+      queue_.pop_front();
+    }
+  }
+
+  queued_bytes_ += buffer.size();
+  queue_.push_back(std::move(buffer));
+  lock.unlock();
+  queue_not_empty_.notify_one();
+}
+
+std::string AsyncWriter::acquire_buffer() {
+  const std::lock_guard lock(mutex_);
+  if (spare_buffers_.empty()) {
+    return {};
+  }
+
+  std::string buffer = std::move(spare_buffers_.back());
+  spare_buffers_.pop_back();
+  return buffer;
+}
+
+void AsyncWriter::wait_idle() {
+  std::unique_lock lock(mutex_);
+  idle_.wait(lock, [this]() { return queue_.empty() && !writing_; });
+}
+
+const AsyncWriterOptions& AsyncWriter::options() const noexcept {
+  return options_;
+}
+
+AsyncWriterStats AsyncWriter::stats() const {
+  const std::lock_guard lock(mutex_);
+  AsyncWriterStats stats = stats_;
+  stats.bytes_written = bytes_written();
+  stats.bytes_dropped = bytes_dropped();
+  return stats;
+}
+
+std::uint64_t AsyncWriter::bytes_written() const noexcept {
+  return bytes_written_.load(std::memory_order_relaxed);
+}
+
+std::uint64_t AsyncWriter::bytes_dropped() const noexcept {
+  return bytes_dropped_.load(std::memory_order_relaxed);
+}
+
+void AsyncWriter::run() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    queue_not_empty_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      break;
+    }
+
+    std::string buffer = std::move(queue_.front());
+    queue_.pop_front();
+    queued_bytes_ -= buffer.size();
+    const std::uint64_t dropped_lines = std::exchange(dropped_lines_, 0U);
+    writing_ = true;
+    lock.unlock();
+    queue_not_full_.notify_all();
+
+    if (dropped_lines != 0U) {
+      std::string summary = last_write_ended_line_ ? "" : "\n";
+      summary += "... " + std::to_string(dropped_lines) +
+                 " lines dropped while the terminal caught up ...\n";
+      write_all(summary);
+    }
+    write_all(buffer);
+    last_write_ended_line_ = buffer.back() == '\n';
+
+    lock.lock();
+    writing_ = false;
+    ++stats_.buffers_written;
+    if (spare_buffers_.size() < kMaxSpareBuffers) {
+      buffer.clear();
+      spare_buffers_.push_back(std::move(buffer));
+    }
+    if (queue_.empty()) {
+      idle_.notify_all();
+    }
+  }
+}
+
+void AsyncWriter::write_all(std::string_view bytes) {
+  std::uint64_t write_calls = 0;
+  std::uint64_t bytes_written = 0;
+
+  while (!bytes.empty()) {
+    ++write_calls;
+#if defined(_WIN32)
+    const int written =
+        _write(file_descriptor_, bytes.data(), static_cast<unsigned int>(bytes.size()));
+#else
+    const ssize_t written = ::write(file_descriptor_, bytes.data(), bytes.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+#endif
+    if (written <= 0) {
+      break;
+    }
+    bytes_written += static_cast<std::uint64_t>(written);
+    bytes.remove_prefix(static_cast<std::size_t>(written));
+  }
+
+  const std::lock_guard lock(mutex_);
+  stats_.write_calls += write_calls;
+  bytes_written_.fetch_add(bytes_written, std::memory_order_relaxed);
+}
+
+} // namespace opentui
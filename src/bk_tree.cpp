@@ -0,0 +1,132 @@
+#include "opentui/bk_tree.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+namespace opentui {
+namespace {
+
+// Wagner-Fischer keeping a single row: `row` holds the distances from the prefix of `left` seen so
+// far to every prefix of `right` and is updated in place. Returns `limit + 1` as soon as the
+// distance is known to exceed `limit`, which for most pairs of words is after a few rows.
+[[nodiscard]] std::size_t bounded_edit_distance(std::string_view left, std::string_view right,
+                                                const std::size_t limit,
+                                                std::vector<std::size_t>& row) {
+  if (left.size() < right.size()) {
+    std::swap(left, right);
+  }
+  if (left.size() - right.size() > limit) {
+    return limit + 1U;
+  }
+
+  row.resize(right.size() + 1U);
+  std::iota(row.begin(), row.end(), std::size_t{0});
+
+  for (std::size_t left_index = 0; left_index < left.size(); ++left_index) {
+    std::size_t diagonal = row[0];
+    row[0] = left_index + 1U;
+    std::size_t row_minimum = row[0];
+    for (std::size_t right_index = 0; right_index < right.size(); ++right_index) {
+      const std::size_t above = row[right_index + 1U];
+      const std::size_t substitution =
+          diagonal + (left[left_index] == right[right_index] ? 0U : 1U);
+      row[right_index + 1U] = std::min({substitution, above + 1U, row[right_index] + 1U});
+      row_minimum = std::min(row_minimum, row[right_index + 1U]);
+      diagonal = above;
+    }
+    // Distances never shrink from one row to the next.
+    if (row_minimum > limit) {
+      return limit + 1U;
+    }
+  }
+  return std::min(row.back(), limit + 1U);
+}
+
+[[nodiscard]] std::size_t edit_distance(std::string_view left, std::string_view right,
+                                        std::vector<std::size_t>& row) {
+  return bounded_edit_distance(left, right, std::max(left.size(), right.size()), row);
+}
+
+} // namespace
+
+std::size_t edit_distance(std::string_view left, std::string_view right, const std::size_t limit) {
+  std::vector<std::size_t> row;
+  return bounded_edit_distance(left, right,
+                               std::min(limit, std::max(left.size(), right.size())), row);
+}
+
+void BkTree::add(std::string_view word, std::string_view value) {
+  const auto index = static_cast<std::uint32_t>(nodes_.size());
+  if (nodes_.empty()) {
+    nodes_.push_back(Node{.word = word, .value = value});
+    return;
+  }
+
+  std::vector<std::size_t> row;
+  std::uint32_t parent = 0;
+  while (true) {
+    const auto distance = static_cast<std::uint32_t>(edit_distance(word, nodes_[parent].word, row));
+
+    std::uint32_t child = nodes_[parent].first_child;
+    while (child != kNoNode && nodes_[child].distance != distance) {
+      child = nodes_[child].next_sibling;
+    }
+    if (child == kNoNode) {
+      nodes_.push_back(Node{
+          .word = word,
+          .value = value,
+          .distance = distance,
+          .next_sibling = nodes_[parent].first_child,
+      });
+      nodes_[parent].first_child = index;
+      nodes_[parent].max_child_distance = std::max(nodes_[parent].max_child_distance, distance);
+      return;
+    }
+    parent = child;
+  }
+}
+
+std::size_t BkTree::size() const noexcept {
+  return nodes_.size();
+}
+
+void BkTree::find_within(std::string_view query, std::size_t max_distance,
+                         std::vector<BkMatch>& matches) const {
+  matches.clear();
+  if (nodes_.empty()) {
+    return;
+  }
+
+  std::vector<std::size_t> row;
+  std::vector<std::uint32_t> pending{0};
+  while (!pending.empty()) {
+    const Node& node = nodes_[pending.back()];
+    pending.pop_back();
+
+    // Past this no child can be in range and the node itself does not match, so the exact
+    // distance is not needed.
+    const std::size_t limit = node.max_child_distance + max_distance;
+    const std::size_t distance = bounded_edit_distance(query, node.word, limit, row);
+    if (distance <= max_distance) {
+      matches.push_back(BkMatch{.word = node.word, .value = node.value, .distance = distance});
+    }
+
+    const std::size_t lowest = distance > max_distance ? distance - max_distance : 0U;
+    const std::size_t highest = distance + max_distance;
+    for (std::uint32_t child = node.first_child; child != kNoNode;
+         child = nodes_[child].next_sibling) {
+      if (nodes_[child].distance >= lowest && nodes_[child].distance <= highest) {
+        pending.push_back(child);
+      }
+    }
+  }
+
+  std::ranges::sort(matches, [](const BkMatch& left, const BkMatch& right) {
+    return std::tie(left.distance, left.word, left.value) <
+           std::tie(right.distance, right.word, right.value);
+  });
+}
+
+} // namespace opentui
@@ -0,0 +1,101 @@
+#include "opentui/command_line.hpp"
+
+#include <cctype>
+
+namespace opentui {
+namespace {
+
+[[nodiscard]] bool is_space(const char character) noexcept {
+  return std::isspace(static_cast<unsigned char>(character)) != 0;
+}
+
+} // namespace
+
+TokenizedLine::TokenizedLine(std::string_view line) {
+  assign(line);
+}
+
+void TokenizedLine::assign(std::string_view line) {
+  tokens_.clear();
+  arena_.clear();
+  // Unquoting only ever drops characters, so the arena never outgrows the line and never moves
+  // under the views already taken into it.
+  arena_.reserve(line.size());
+
+  std::size_t index = 0;
+  while (index < line.size()) {
+    if (is_space(line[index])) {
+      ++index;
+      continue;
+    }
+
+    // Scan the plain run of the token; most tokens end here and can view the line as they are.
+    const std::size_t start = index;
+    while (index < line.size() && !is_space(line[index]) && line[index] != '"' &&
+           line[index] != '\'' && (line[index] != '\\' || index + 1U == line.size())) {
+      ++index;
+    }
+    if (index == line.size() || is_space(line[index])) {
+      tokens_.push_back(line.substr(start, index - start));
+      continue;
+    }
+
+    // A quote or escape needs rewriting: copy what was scanned so far and unquote the rest.
+    const std::size_t arena_start = arena_.size();
+    arena_.append(line.substr(start, index - start));
+    char quote = '\0';
+    for (; index < line.size(); ++index) {
+      const char character = line[index];
+
+      if (character == '\\' && (index + 1U) < line.size()) {
+        arena_.push_back(line[index + 1U]);
+        ++index;
+        continue;
+      }
+
+      if (quote != '\0') {
+        if (character == quote) {
+          quote = '\0';
+        } else {
+          arena_.push_back(character);
+        }
+        continue;
+      }
+
+      if (character == '"' || character == '\'') {
+        quote = character;
+        continue;
+      }
+
+      if (is_space(character)) {
+        break;
+      }
+
+      arena_.push_back(character);
+    }
+
+    if (arena_.size() != arena_start) {
+      tokens_.push_back(std::string_view{arena_}.substr(arena_start));
+    }
+  }
+}
+
+void split_words(std::string_view text, std::vector<std::string_view>& words) {
+  words.clear();
+
+  std::size_t index = 0;
+  while (index < text.size()) {
+    if (is_space(text[index])) {
+      ++index;
+      continue;
+    }
+
+    const std::size_t start = index;
+    while (index < text.size() && !is_space(text[index])) {
+      ++index;
+    }
+    words.push_back(text.substr(start, index - start));
+  }
+}
+
+} // namespace opentui
@@ -3,48 +3,46 @@
 #include <algorithm>
 #include <cctype>
 #include <iomanip>
+#include <istream>
+#include <limits>
 #include <ranges>
 #include <sstream>
+#include <utility>
 
 #include "opentui/console.hpp"
+#include "opentui/fuzzy_matcher.hpp"
+#include "opentui/job_manager.hpp"
 
 namespace opentui {
 namespace {
 
-[[nodiscard]] std::vector<std::string> split_for_completion(std::string_view line) {
-  std::vector<std::string> parts;
-  std::string current;
-
-  for (const char c : line) {
-    if (std::isspace(static_cast<unsigned char>(c)) != 0) {
-      if (!current.empty()) {
-        parts.push_back(current);
-        current.clear();
-      }
-      continue;
+void append_joined(std::string& output, const ArgsView values) {
+  for (std::size_t index = 0; index < values.size(); ++index) {
+    if (index != 0U) {
+      output += ' ';
     }
-    current.push_back(c);
+    output += values[index];
   }
+}
 
-  if (!current.empty()) {
-    parts.push_back(current);
+// What completions of a command's arguments start with: the command name and the finished
+// arguments, each followed by a space.
+[[nodiscard]] std::string argument_prefix(const std::string_view command_name,
+                                          const ArgsView stable_args) {
+  std::string prefix{command_name};
+  prefix += ' ';
+  if (!stable_args.empty()) {
+    append_joined(prefix, stable_args);
+    prefix += ' ';
   }
-
-  return parts;
+  return prefix;
 }
 
-[[nodiscard]] std::string join_with_spaces(const Args& values) {
-  std::ostringstream output;
-  for (std::size_t index = 0; index < values.size(); ++index) {
-    if (index != 0U) {
-      output << ' ';
-    }
-    output << values[index];
-  }
-  return output.str();
+[[nodiscard]] bool unslashed_less(std::string_view left, std::string_view right) {
+  return left.substr(1) < right.substr(1);
 }
 
-[[nodiscard]] std::string join_with_commas(const std::vector<std::string>& values) {
+[[nodiscard]] std::string join_with_commas(const std::vector<std::string_view>& values) {
   std::ostringstream output;
   for (std::size_t index = 0; index < values.size(); ++index) {
     if (index != 0U) {
@@ -58,21 +56,89 @@ namespace {
 } // namespace
 
 bool CommandRegistry::add(Command command) {
-  if (command.name.empty() || !command.handler) {
+  if (command.name.empty() || (!command.handler && !command.async_handler)) {
+    return false;
+  }
+
+  if (std::ranges::any_of(tables_, [&command](const BoundTable& bound) {
+        return bound.table.find(command.name).has_value();
+      })) {
+    return false;
+  }
+
+  auto [iterator, inserted] = commands_.emplace(command.name, std::move(command));
+  if (!inserted) {
     return false;
   }
 
-  auto [_, inserted] = commands_.emplace(command.name, std::move(command));
-  return inserted;
+  index_name(iterator->first);
+  return true;
+}
+
+bool CommandRegistry::add_table(CommandTableView table, std::vector<CommandBinding> bindings) {
+  const std::span<const CommandSpec> specs = table.commands();
+  std::vector<CommandBinding*> binding_of(specs.size(), nullptr);
+  for (CommandBinding& binding : bindings) {
+    const std::optional<std::size_t> command = table.find(binding.name);
+    if (!command.has_value() || specs[*command].name != binding.name ||
+        binding_of[*command] != nullptr || (!binding.handler && !binding.async_handler)) {
+      return false;
+    }
+    binding_of[*command] = &binding;
+  }
+  if (bindings.size() != specs.size() ||
+      std::ranges::any_of(table.slots(), [this](const CommandTableName& slot) {
+        return !slot.name.empty() && contains(slot.name);
+      })) {
+    return false;
+  }
+
+  BoundTable& bound = tables_.emplace_back(BoundTable{.table = table, .commands = {}});
+  bound.commands.reserve(specs.size());
+  for (std::size_t index = 0; index < specs.size(); ++index) {
+    const CommandSpec& spec = specs[index];
+    CommandBinding& binding = *binding_of[index];
+    bound.commands.push_back(Command{
+        .name = std::string{spec.name},
+        .description = std::string{spec.description},
+        .handler = std::move(binding.handler),
+        .completer = std::move(binding.completer),
+        .narrowable = spec.narrowable,
+        .async_handler = std::move(binding.async_handler),
+    });
+  }
+
+  for (const CommandTableName& slot : table.slots()) {
+    if (!slot.name.empty()) {
+      index_name(slot.name);
+    }
+  }
+  return true;
+}
+
+void CommandRegistry::index_name(std::string_view name) {
+  name_views_.insert(std::ranges::upper_bound(name_views_, name), name);
+  names_by_spelling_.add(name, name);
+  if (name.starts_with('/')) {
+    unslashed_names_.insert(std::ranges::upper_bound(unslashed_names_, name, unslashed_less),
+                            name);
+    names_by_spelling_.add(name.substr(1), name);
+  }
 }
 
 bool CommandRegistry::contains(std::string_view name) const {
-  return commands_.contains(std::string{name});
+  return find(name).has_value();
 }
 
 std::optional<std::reference_wrapper<const Command>>
 CommandRegistry::find(std::string_view name) const {
-  const auto iterator = commands_.find(std::string{name});
+  for (const BoundTable& bound : tables_) {
+    if (const std::optional<std::size_t> command = bound.table.find(name); command.has_value()) {
+      return std::cref(bound.commands[*command]);
+    }
+  }
+
+  const auto iterator = commands_.find(name);
   if (iterator == commands_.end()) {
     return std::nullopt;
   }
@@ -81,181 +147,360 @@ CommandRegistry::find(std::string_view name) const {
 
 std::vector<std::string> CommandRegistry::names() const {
   std::vector<std::string> values;
-  values.reserve(commands_.size());
-  for (const auto& [name, _] : commands_) {
-    values.push_back(name);
+  values.reserve(name_views_.size());
+  for (const std::string_view name : name_views_) {
+    values.emplace_back(name);
   }
   return values;
 }
 
+void CommandRegistry::names_with_prefix(std::string_view prefix,
+                                        std::vector<std::string_view>& matches) const {
+  matches.clear();
+
+  const auto literal = std::ranges::equal_range(
+      name_views_, prefix, {}, [&prefix](std::string_view name) {
+        return name.substr(0, prefix.size());
+      });
+  const auto unslashed = std::ranges::equal_range(
+      unslashed_names_, prefix, {}, [&prefix](std::string_view name) {
+        return name.substr(1, prefix.size());
+      });
+
+  // Both ranges are in name order (every unslashed entry shares the leading '/'), so merging them
+  // keeps that order. A name lands in both only when it starts with '/' followed by `prefix`.
+  auto next_literal = literal.begin();
+  auto next_unslashed = unslashed.begin();
+  while (next_literal != literal.end() || next_unslashed != unslashed.end()) {
+    if (next_unslashed == unslashed.end() ||
+        (next_literal != literal.end() && *next_literal < *next_unslashed)) {
+      matches.push_back(*next_literal++);
+    } else if (next_literal == literal.end() || *next_unslashed < *next_literal) {
+      matches.push_back(*next_unslashed++);
+    } else {
+      matches.push_back(*next_literal++);
+      ++next_unslashed;
+    }
+  }
+}
+
+void CommandRegistry::names_near(std::string_view token, std::size_t limit,
+                                 std::vector<std::string_view>& matches) const {
+  matches.clear();
+
+  constexpr std::size_t kShortTokenLength = 3;
+  const std::size_t max_distance = token.size() <= kShortTokenLength ? 1U : 2U;
+  std::vector<BkMatch> near;
+  names_by_spelling_.find_within(token, max_distance, near);
+
+  for (const BkMatch& match : near) {
+    if (matches.size() == limit) {
+      break;
+    }
+    // A slash name can match both with and without its slash; the nearer spelling comes first.
+    if (std::ranges::find(matches, match.value) == matches.end()) {
+      matches.push_back(match.value);
+    }
+  }
+}
+
 std::vector<std::string> CommandRegistry::complete(std::string_view buffer) const {
-  std::vector<std::string> completions;
+  CompletionCache cache;
+  return complete(buffer, cache);
+}
+
+std::vector<std::string> CommandRegistry::complete(std::string_view buffer,
+                                                   CompletionCache& cache) const {
+  return complete_page(buffer, 0U, std::numeric_limits<std::size_t>::max(), cache).candidates;
+}
+
+CompletionPage CommandRegistry::complete_page(std::string_view buffer, const std::size_t offset,
+                                             const std::size_t count, CompletionCache& cache,
+                                             const std::stop_token stop_token) const {
+  CompletionPage page{.offset = offset};
 
+  std::vector<std::string_view> tokens;
+  split_words(buffer, tokens);
   const bool trailing_space =
       !buffer.empty() && std::isspace(static_cast<unsigned char>(buffer.back())) != 0;
-  const std::vector<std::string> tokens = split_for_completion(buffer);
+  if (tokens.size() > 1U || (tokens.size() == 1U && trailing_space)) {
+    const auto command = find(tokens.front());
+    if (command.has_value() && !command->get().completer && command->get().paged_completer) {
+      const ArgsView words{tokens};
+      const ArgsView stable_args =
+          trailing_space ? words.subview(1) : words.subview(1, tokens.size() - 2U);
+      const std::string_view partial = trailing_space ? std::string_view{} : words.back();
+
+      page.total = command->get().paged_completer(partial, stable_args, offset, count,
+                                                  page.candidates, stop_token);
+      if (stop_token.stop_requested()) {
+        return CompletionPage{.offset = offset};
+      }
+      const std::string prefix = argument_prefix(tokens.front(), stable_args);
+      for (std::string& candidate : page.candidates) {
+        candidate.insert(0, prefix);
+      }
+      return page;
+    }
+  }
 
-  if (tokens.empty()) {
-    const auto command_names = names();
-    completions.reserve(command_names.size());
-    for (const auto& command_name : command_names) {
-      completions.push_back(command_name + " ");
+  const CompletionSource source = completion_source(buffer, cache);
+  if (source.list == nullptr || stop_token.stop_requested()) {
+    return page;
+  }
+  const FuzzyIndex& list = *source.list;
+  const std::size_t first = std::min(offset, list.size());
+  const std::size_t last = first + std::min(count, list.size() - first);
+  std::size_t matching = 0;
+  const std::vector<FuzzyMatch> best = list.search(source.partial, last, &matching);
+  page.total = source.keep_unmatched ? list.size() : matching;
+
+  const auto append = [&page, &source](const std::string_view entry) {
+    std::string& candidate = page.candidates.emplace_back(source.prefix);
+    candidate += entry;
+    candidate += source.suffix;
+  };
+  for (std::size_t rank = first; rank < best.size(); ++rank) {
+    append(list[best[rank].index]);
+  }
+  if (source.keep_unmatched && last > matching) {
+    // Entries that do not match the token keep their alphabetical order after the matches.
+    const FuzzyMatcher matcher(source.partial);
+    std::size_t skipped = first > matching ? first - matching : 0U;
+    for (std::size_t index = 0; index < list.size() && page.candidates.size() < last - first;
+         ++index) {
+      if (matcher.matches(list[index])) {
+        continue;
+      }
+      if (skipped != 0U) {
+        --skipped;
+        continue;
+      }
+      append(list[index]);
     }
-    return completions;
   }
+  return page;
+}
 
-  if (tokens.size() == 1U && !trailing_space) {
-    const std::string_view partial = tokens.front();
-    for (const auto& [name, _] : commands_) {
-      const std::string_view command_name{name};
-      if (command_name.starts_with(partial) ||
-          (command_name.starts_with('/') && command_name.substr(1).starts_with(partial))) {
-        completions.push_back(name + " ");
+CommandRegistry::CompletionSource
+CommandRegistry::completion_source(std::string_view buffer, CompletionCache& cache) const {
+  const bool trailing_space =
+      !buffer.empty() && std::isspace(static_cast<unsigned char>(buffer.back())) != 0;
+  std::vector<std::string_view> tokens;
+  split_words(buffer, tokens);
+
+  if (tokens.empty() || (tokens.size() == 1U && !trailing_space)) {
+    // Command names live in the empty scope; argument scopes always start with a command name.
+    constexpr std::string_view kCommandNameScope;
+    const FuzzyIndex* names = cache.narrowest_list(kCommandNameScope, {});
+    if (names == nullptr) {
+      FuzzyIndex all;
+      for (const std::string_view command_name : name_views_) {
+        all.add(command_name);
       }
+      names = &cache.store_list(kCommandNameScope, {}, std::move(all));
     }
-    return completions;
+    return CompletionSource{.list = names,
+                            .partial = tokens.empty() ? std::string_view{} : tokens.front(),
+                            .suffix = " "};
   }
 
   const std::string_view command_name = tokens.front();
   const auto command = find(command_name);
   if (!command.has_value() || !command->get().completer) {
-    return completions;
+    return {};
   }
 
-  Args stable_args;
-  std::string partial;
-
-  if (trailing_space) {
-    if (tokens.size() > 1U) {
-      stable_args.assign(tokens.begin() + 1, tokens.end());
-    }
-  } else {
-    if (tokens.size() > 2U) {
-      stable_args.assign(tokens.begin() + 1, tokens.end() - 1);
-    }
-    partial = tokens.back();
-  }
-
-  const auto suggestions = command->get().completer(partial, stable_args);
-  if (suggestions.empty()) {
-    return completions;
-  }
-
-  std::string prefix{command_name};
-  prefix += ' ';
-  if (!stable_args.empty()) {
-    prefix += join_with_spaces(stable_args);
-    prefix += ' ';
+  const ArgsView words{tokens};
+  const ArgsView stable_args =
+      trailing_space ? words.subview(1) : words.subview(1, tokens.size() - 2U);
+  const std::string_view partial = trailing_space ? std::string_view{} : words.back();
+
+  // A narrowable list serves every longer token as well, so it is cached under the arguments
+  // before the token; any other list serves only its own token, which joins the scope.
+  std::string scope{command_name};
+  scope += '\n';
+  append_joined(scope, stable_args);
+  std::string_view listed_for = partial;
+  if (!command->get().narrowable) {
+    scope += '\n';
+    scope += partial;
+    listed_for = {};
   }
 
-  completions.reserve(suggestions.size());
-  for (const auto& suggestion : suggestions) {
-    completions.push_back(prefix + suggestion);
+  const FuzzyIndex* list = cache.narrowest_list(scope, listed_for);
+  if (list == nullptr) {
+    std::vector<std::string> suggestions = command->get().completer(partial, stable_args);
+    std::ranges::sort(suggestions);
+    const auto unique_result = std::ranges::unique(suggestions);
+    suggestions.erase(unique_result.begin(), suggestions.end());
+    list = &cache.store_list(scope, listed_for, FuzzyIndex(suggestions));
   }
-
-  std::ranges::sort(completions);
-  const auto unique_result = std::ranges::unique(completions);
-  completions.erase(unique_result.begin(), completions.end());
-  return completions;
+  return CompletionSource{.list = list,
+                          .partial = partial,
+                          .prefix = argument_prefix(command_name, stable_args),
+                          .keep_unmatched = !command->get().narrowable};
 }
 
 std::string CommandRegistry::help_text() const {
-  std::ostringstream output;
-  output << "Available commands:\n";
+  // Table commands list their aliases after their name.
+  std::vector<std::pair<std::string, std::string_view>> rows;
+  for (const BoundTable& bound : tables_) {
+    for (const CommandSpec& spec : bound.table.commands()) {
+      std::string label{spec.name};
+      for (const std::string_view alias : spec.aliases) {
+        if (!alias.empty()) {
+          label += ", ";
+          label += alias;
+        }
+      }
+      rows.emplace_back(std::move(label), spec.description);
+    }
+  }
+  for (const auto& [name, command] : commands_) {
+    rows.emplace_back(name, command.description);
+  }
+  std::ranges::sort(rows);
 
   std::size_t max_name_width = 0;
-  for (const auto& [name, _] : commands_) {
-    max_name_width = std::max(max_name_width, name.size());
+  for (const auto& [label, _] : rows) {
+    max_name_width = std::max(max_name_width, label.size());
   }
 
-  for (const auto& [name, command] : commands_) {
-    output << "  " << std::left << std::setw(static_cast<int>(max_name_width)) << name << "  "
-           << command.description << '\n';
+  std::ostringstream output;
+  output << "Available commands:\n";
+  for (const auto& [label, description] : rows) {
+    output << "  " << std::left << std::setw(static_cast<int>(max_name_width)) << label << "  "
+           << description << '\n';
   }
 
   return output.str();
 }
 
 bool CommandRegistry::execute_line(std::string_view line, CommandContext& context) const {
-  const Args tokens = tokenize(line);
+  TokenizedLine tokens;
+  return execute_line(line, context, tokens);
+}
+
+bool CommandRegistry::execute_line(std::string_view line, CommandContext& context,
+                                   TokenizedLine& tokens) const {
+  tokens.assign(line);
   if (tokens.empty()) {
     return true;
   }
 
-  const auto command = find(tokens.front());
+  const std::string_view name = tokens.tokens().front();
+  const auto command = find(name);
   if (!command.has_value()) {
-    context.console.println_color("Unknown command: " + tokens.front(), Color::BrightRed);
-
-    std::vector<std::string> suggestions;
-    const std::string_view partial = tokens.front();
-    for (const auto& [name, _] : commands_) {
-      const std::string_view command_name{name};
-      if (command_name.starts_with(partial) ||
-          (command_name.starts_with('/') && command_name.substr(1).starts_with(partial))) {
-        suggestions.push_back(name);
-      }
-    }
+    std::string message{"Unknown command: "};
+    message += name;
+    context.console.println_color(message, Color::BrightRed);
+
+    std::vector<std::string_view> suggestions;
+    names_with_prefix(name, suggestions);
 
     if (!suggestions.empty()) {
       context.console.println("Possible matches: " + join_with_commas(suggestions));
+    } else {
+      constexpr std::size_t kMaxTypoSuggestions = 5;
+      names_near(name, kMaxTypoSuggestions, suggestions);
+      if (!suggestions.empty()) {
+        context.console.println("Did you mean: " + join_with_commas(suggestions));
+      }
     }
 
     return false;
   }
 
-  Args args;
-  if (tokens.size() > 1U) {
-    args.assign(tokens.begin() + 1, tokens.end());
+  context.failed = false;
+  const ArgsView args = tokens.tokens().subview(1);
+  if (!command->get().async_handler) {
+    command->get().handler(args, context);
+    return !context.failed;
   }
 
-  command->get().handler(args, context);
-  return true;
+  CommandTask task = command->get().async_handler(args, context);
+  if (context.failed || !task) {
+    return !context.failed;
+  }
+  if (context.jobs != nullptr) {
+    context.jobs->start(std::string{line}, std::move(task), context);
+    return true;
+  }
+  // Without a job manager the task runs in the foreground; what it posted is printed in order.
+  task(context);
+  context.console.drain_posted();
+  return !context.failed;
 }
 
-Args CommandRegistry::tokenize(std::string_view line) {
-  Args tokens;
-  std::string current;
-  char quote = '\0';
-
-  for (std::size_t index = 0; index < line.size(); ++index) {
-    const char character = line[index];
-
-    if (character == '\\' && (index + 1U) < line.size()) {
-      current.push_back(line[index + 1U]);
-      ++index;
-      continue;
+ScriptResult CommandRegistry::run_script(std::istream& input, CommandContext& context,
+                                         const ScriptOptions& options) const {
+  ScriptResult result;
+  TokenizedLine tokens;
+  std::string chunk(std::max<std::size_t>(options.chunk_bytes, 1U), '\0');
+  std::size_t filled = 0;
+  std::size_t line_number = 0;
+
+  // Runs one line; returns false when the script has to stop.
+  const auto run_line = [&](std::string_view line) {
+    ++line_number;
+    if (line.ends_with('\r')) {
+      line.remove_suffix(1);
     }
-
-    if (quote != '\0') {
-      if (character == quote) {
-        quote = '\0';
-      } else {
-        current.push_back(character);
-      }
-      continue;
+    const std::size_t start = line.find_first_not_of(" \t");
+    if (start == std::string_view::npos || line[start] == '#') {
+      return true;
     }
 
-    if (character == '"' || character == '\'') {
-      quote = character;
-      continue;
+    const bool succeeded = execute_line(line, context, tokens);
+    ++result.commands;
+    if (!succeeded) {
+      ++result.failed;
+      result.failed_lines.push_back(line_number);
+    }
+    if (options.on_command) {
+      options.on_command(line_number, line, succeeded);
+    }
+    return (succeeded || !options.stop_on_error) && context.running.load();
+  };
+
+  bool at_end = false;
+  while (!at_end) {
+    // A line longer than the chunk grows it; otherwise the chunk is reused as is.
+    if (filled == chunk.size()) {
+      chunk.resize(chunk.size() * 2U);
     }
+    input.read(chunk.data() + filled, static_cast<std::streamsize>(chunk.size() - filled));
+    filled += static_cast<std::size_t>(input.gcount());
+    at_end = !input;
+
+    const std::string_view text{chunk.data(), filled};
+    std::size_t consumed = 0;
+    while (consumed < filled) {
+      std::size_t line_end = text.find('\n', consumed);
+      if (line_end == std::string_view::npos) {
+        if (!at_end) {
+          break;
+        }
+        line_end = filled;
+      }
 
-    if (std::isspace(static_cast<unsigned char>(character)) != 0) {
-      if (!current.empty()) {
-        tokens.push_back(current);
-        current.clear();
+      const std::string_view line = text.substr(consumed, line_end - consumed);
+      consumed = std::min(line_end + 1U, filled);
+      if (!run_line(line)) {
+        context.console.flush();
+        result.stopped = true;
+        return result;
       }
-      continue;
     }
 
-    current.push_back(character);
-  }
-
-  if (!current.empty()) {
-    tokens.push_back(current);
+    context.console.flush();
+    std::copy(chunk.begin() + static_cast<std::ptrdiff_t>(consumed),
+              chunk.begin() + static_cast<std::ptrdiff_t>(filled), chunk.begin());
+    filled -= consumed;
   }
 
-  return tokens;
+  return result;
 }
 
 } // namespace opentui
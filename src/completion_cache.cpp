@@ -0,0 +1,48 @@
+#include "opentui/completion_cache.hpp"
+
+#include <utility>
+
+namespace opentui {
+
+const FuzzyIndex* CompletionCache::narrowest_list(std::string_view scope,
+                                                  std::string_view partial) {
+  const ListEntry* best = nullptr;
+  for (const ListEntry& entry : lists_) {
+    if (entry.scope == scope && partial.starts_with(entry.partial) &&
+        (best == nullptr || entry.partial.size() > best->partial.size())) {
+      best = &entry;
+    }
+  }
+
+  if (best == nullptr) {
+    ++stats_.misses;
+    return nullptr;
+  }
+  if (best->partial.size() == partial.size()) {
+    ++stats_.exact_hits;
+  } else {
+    ++stats_.narrowed;
+  }
+  return &best->list;
+}
+
+const FuzzyIndex& CompletionCache::store_list(std::string_view scope, std::string_view partial,
+                                              FuzzyIndex list) {
+  if (lists_.size() >= kMaxLists) {
+    lists_.erase(lists_.begin());
+  }
+  ListEntry& entry = lists_.emplace_back(ListEntry{.scope = std::string{scope},
+                                                  .partial = std::string{partial},
+                                                  .list = std::move(list)});
+  return entry.list;
+}
+
+void CompletionCache::clear() noexcept {
+  lists_.clear();
+}
+
+const CompletionCacheStats& CompletionCache::stats() const noexcept {
+  return stats_;
+}
+
+} // namespace opentui
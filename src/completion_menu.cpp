@@ -0,0 +1,138 @@
+#include "opentui/completion_menu.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+
+#include "opentui/display_width.hpp"
+#include "opentui/style.hpp"
+
+namespace opentui {
+namespace {
+
+constexpr Style kSelectedStyle{Color::Black, Color::Cyan};
+constexpr Style kPositionStyle{Color::BrightBlack};
+
+void append_candidate(std::string& row, std::string_view candidate) {
+  while (!candidate.empty() && std::isspace(static_cast<unsigned char>(candidate.back())) != 0) {
+    candidate.remove_suffix(1);
+  }
+  if (display_width(candidate) <= CompletionMenu::kMaxCandidateWidth) {
+    row.append(candidate);
+  } else {
+    row.append(truncate_to_width(candidate, CompletionMenu::kMaxCandidateWidth));
+  }
+}
+
+} // namespace
+
+CompletionMenu::CompletionMenu(const std::size_t height) noexcept
+    : height_(std::max<std::size_t>(height, 1U)) {}
+
+void CompletionMenu::set_height(const std::size_t height) noexcept {
+  height_ = std::max<std::size_t>(height, 1U);
+}
+
+std::size_t CompletionMenu::height() const noexcept {
+  return height_;
+}
+
+void CompletionMenu::reset() noexcept {
+  top_ = 0;
+  selected_.reset();
+}
+
+bool CompletionMenu::move(const std::ptrdiff_t delta, const std::size_t count) noexcept {
+  if (count == 0U) {
+    reset();
+    return false;
+  }
+
+  const std::size_t last = count - 1U;
+  if (!selected_.has_value()) {
+    selected_ = delta >= 0 ? 0U : last;
+  } else {
+    const std::size_t current = std::min(*selected_, last);
+    if (delta == 1 && current == last) {
+      selected_ = 0U;
+    } else if (delta == -1 && current == 0U) {
+      selected_ = last;
+    } else if (delta >= 0) {
+      selected_ = std::min(current + static_cast<std::size_t>(delta), last);
+    } else {
+      selected_ = current - std::min(current, static_cast<std::size_t>(-delta));
+    }
+  }
+
+  if (*selected_ < top_) {
+    top_ = *selected_;
+  } else if (*selected_ >= top_ + height_) {
+    top_ = *selected_ + 1U - height_;
+  }
+  return true;
+}
+
+std::optional<std::size_t> CompletionMenu::selected() const noexcept {
+  return selected_;
+}
+
+void CompletionMenu::build_rows(std::span<const std::string> candidates,
+                                std::vector<std::string>& rows, const std::size_t total) {
+  build_rows_with(
+      candidates.size(), [candidates](const std::size_t index) { return candidates[index]; },
+      rows, total);
+}
+
+void CompletionMenu::build_rows(std::span<const std::string> candidates,
+                                std::span<const std::uint32_t> indices,
+                                std::vector<std::string>& rows) {
+  build_rows_with(
+      indices.size(),
+      [candidates, indices](const std::size_t index) { return candidates[indices[index]]; }, rows,
+      indices.size());
+}
+
+template <typename CandidateAt>
+void CompletionMenu::build_rows_with(const std::size_t count, const CandidateAt& candidate_at,
+                                     std::vector<std::string>& rows, const std::size_t total) {
+  rows.clear();
+  if (count == 0U) {
+    reset();
+    return;
+  }
+
+  // A shorter list than the one the position was computed for keeps the last page in view.
+  if (selected_.has_value() && *selected_ >= count) {
+    selected_ = count - 1U;
+  }
+  top_ = std::min(top_, count - std::min(count, height_));
+
+  const std::size_t end = std::min(count, top_ + height_);
+  for (std::size_t index = top_; index < end; ++index) {
+    std::string& row = rows.emplace_back();
+    if (selected_ == index) {
+      row.append(kSelectedStyle.prefix());
+      row.append("> ");
+      append_candidate(row, candidate_at(index));
+      row.append(Style::reset());
+    } else {
+      row.append("  ");
+      append_candidate(row, candidate_at(index));
+    }
+  }
+
+  const std::size_t listed = std::max(total, count);
+  if (listed > height_) {
+    std::string& row = rows.emplace_back();
+    row.append(kPositionStyle.prefix());
+    row.append("  ");
+    row.append(std::to_string(top_ + 1U));
+    row.push_back('-');
+    row.append(std::to_string(end));
+    row.append(" of ");
+    row.append(std::to_string(listed));
+    row.append(Style::reset());
+  }
+}
+
+} // namespace opentui
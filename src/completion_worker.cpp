@@ -0,0 +1,117 @@
+#include "opentui/completion_worker.hpp"
+
+#include <utility>
+
+namespace opentui {
+
+CompletionWorker::~CompletionWorker() {
+  {
+    const std::lock_guard lock(mutex_);
+    stopping_ = true;
+    pending_.reset();
+    running_stop_.request_stop();
+  }
+  work_available_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void CompletionWorker::set_provider(Provider provider) {
+  const std::lock_guard lock(mutex_);
+  provider_ = std::move(provider);
+}
+
+std::uint64_t CompletionWorker::request(std::string buffer, const std::size_t offset,
+                                        const std::size_t count) {
+  std::uint64_t generation = 0;
+  {
+    const std::lock_guard lock(mutex_);
+    generation = ++latest_generation_;
+    pending_ = Request{
+        .generation = generation, .buffer = std::move(buffer), .offset = offset, .count = count};
+    result_.reset();
+    running_stop_.request_stop();
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this]() { run(); });
+    }
+  }
+  work_available_.notify_one();
+  return generation;
+}
+
+std::optional<CompletionResult> CompletionWorker::take_result() {
+  const std::lock_guard lock(mutex_);
+  return std::exchange(result_, std::nullopt);
+}
+
+std::optional<CompletionResult>
+CompletionWorker::wait_for(const std::uint64_t generation,
+                           const std::chrono::milliseconds timeout) {
+  std::unique_lock lock(mutex_);
+  const auto ready = [this, generation]() {
+    return result_.has_value() && result_->generation == generation;
+  };
+  if (!result_available_.wait_for(lock, timeout, ready)) {
+    return std::nullopt;
+  }
+  return std::exchange(result_, std::nullopt);
+}
+
+void CompletionWorker::cancel_and_wait() {
+  std::unique_lock lock(mutex_);
+  pending_.reset();
+  running_stop_.request_stop();
+  result_available_.wait(lock, [this]() { return !busy_; });
+  result_.reset();
+  ++latest_generation_;
+}
+
+WakeupSignal& CompletionWorker::wakeup() noexcept {
+  return wakeup_;
+}
+
+void CompletionWorker::run() {
+  std::unique_lock lock(mutex_);
+  while (true) {
+    work_available_.wait(lock, [this]() { return stopping_ || pending_.has_value(); });
+    if (stopping_) {
+      break;
+    }
+
+    CompletionResult result{.generation = pending_->generation,
+                            .buffer = std::move(pending_->buffer),
+                            .candidates = {},
+                            .offset = pending_->offset,
+                            .total = 0,
+                            .error = nullptr};
+    const std::size_t count = pending_->count;
+    pending_.reset();
+    running_stop_ = std::stop_source();
+    const std::stop_token stop_token = running_stop_.get_token();
+    busy_ = true;
+    lock.unlock();
+
+    try {
+      CompletionPage page = provider_(result.buffer, result.offset, count, stop_token);
+      result.candidates = std::move(page.candidates);
+      result.offset = page.offset;
+      result.total = page.total;
+    } catch (...) {
+      result.error = std::current_exception();
+    }
+
+    lock.lock();
+    busy_ = false;
+    const bool current = result.generation == latest_generation_;
+    if (current) {
+      result_ = std::move(result);
+    }
+    result_available_.notify_all();
+    if (current) {
+      wakeup_.notify();
+    }
+  }
+}
+
+} // namespace opentui
@@ -1,8 +1,8 @@
 #include "opentui/console.hpp"
 
+#include <algorithm>
 #include <iostream>
-#include <sstream>
-#include <vector>
+#include <utility>
 
 #if defined(_WIN32)
 #include <windows.h>
@@ -14,75 +14,297 @@ namespace opentui {
 
 Console::Console() : ansi_enabled_(enable_virtual_terminal()) {}
 
+Console::~Console() {
+  drain_posted();
+  if (coalescing_) {
+    present_pending();
+  }
+  disable_async_writer();
+}
+
 void Console::print(std::string_view text) {
-  std::cout << text;
+  record(text);
+  write(text);
 }
 
 void Console::println(std::string_view text) {
-  std::cout << text << '\n';
+  print(text);
+  write_line_end();
+}
+
+void Console::print(std::string_view text, const Style style) {
+  record(text);
+  if (!ansi_enabled_ || style.plain()) {
+    write(text);
+    return;
+  }
+
+  write(style.prefix());
+  write(text);
+  write(Style::reset());
+}
+
+void Console::println(std::string_view text, const Style style) {
+  print(text, style);
+  write_line_end();
 }
 
 void Console::print_color(std::string_view text, const Color foreground, const Color background,
                           const bool bold) {
-  std::cout << paint(text, foreground, background, bold);
+  print(text, Style{foreground, background, bold});
 }
 
 void Console::println_color(std::string_view text, const Color foreground, const Color background,
                             const bool bold) {
-  std::cout << paint(text, foreground, background, bold) << '\n';
+  println(text, Style{foreground, background, bold});
 }
 
 std::string Console::paint(std::string_view text, const Color foreground, const Color background,
                            const bool bold) const {
-  if (!ansi_enabled_) {
-    return std::string{text};
+  std::string output;
+  paint_to(output, text, Style{foreground, background, bold});
+  return output;
+}
+
+void Console::paint_to(std::string& buffer, std::string_view text, const Style style) const {
+  if (!ansi_enabled_ || style.plain()) {
+    buffer.append(text);
+    return;
+  }
+
+  const std::string_view prefix = style.prefix();
+  const std::string_view reset = Style::reset();
+  buffer.reserve(buffer.size() + prefix.size() + text.size() + reset.size());
+  buffer.append(prefix);
+  buffer.append(text);
+  buffer.append(reset);
+}
+
+void Console::emit(std::string_view bytes) {
+  write_control(bytes);
+}
+
+void Console::flush() {
+  std::cout << std::flush;
+  if (coalescing_) {
+    present_pending();
+  }
+  output_.flush();
+}
+
+void Console::clear_screen() {
+  if (ansi_enabled_) {
+    write_control("\033[2J\033[H");
+  } else {
+    constexpr std::size_t kFallbackNewlines = 48;
+    write_control(std::string(kFallbackNewlines, '\n'));
+  }
+  flush();
+}
+
+void Console::post(std::string line, const Style style) {
+  posted_count_.fetch_add(1);
+  posted_.push(ConsoleRecord{.text = std::move(line), .style = style});
+  wakeup_.notify();
+}
+
+std::size_t Console::drain_posted() {
+  std::size_t drained = 0;
+  while (auto record = posted_.pop()) {
+    println(record->text, record->style);
+    ++drained;
+  }
+  posted_count_.fetch_sub(drained);
+  return drained;
+}
+
+bool Console::has_posted() const noexcept {
+  return posted_count_.load() != 0U;
+}
+
+WakeupSignal& Console::wakeup() noexcept {
+  return wakeup_;
+}
+
+void Console::enable_async_writer(const AsyncWriterOptions options) {
+  disable_async_writer();
+  output_.flush();
+  async_writer_ = std::make_unique<AsyncWriter>(OutputBuffer::kStandardOutput, options);
+  output_.set_async_writer(async_writer_.get());
+}
+
+void Console::disable_async_writer() {
+  if (!async_writer_) {
+    return;
+  }
+
+  output_.flush();
+  output_.set_async_writer(nullptr);
+  async_writer_.reset();
+}
+
+const AsyncWriter* Console::async_writer() const noexcept {
+  return async_writer_.get();
+}
+
+void Console::set_auto_flush_threshold(const std::size_t bytes) noexcept {
+  output_.set_high_watermark(bytes);
+}
+
+const OutputStats& Console::output_stats() const noexcept {
+  return output_.stats();
+}
+
+void Console::enable_scrollback(const std::size_t memory_limit) {
+  scrollback_ = std::make_unique<Scrollback>(memory_limit);
+}
+
+void Console::disable_scrollback() noexcept {
+  scrollback_.reset();
+}
+
+Scrollback* Console::scrollback() noexcept {
+  return scrollback_.get();
+}
+
+const Scrollback* Console::scrollback() const noexcept {
+  return scrollback_.get();
+}
+
+void Console::enable_coalescing(const CoalescingOptions options) {
+  coalescing_options_ = options;
+  coalescing_options_.frames_per_second = std::max(coalescing_options_.frames_per_second, 1U);
+  coalescing_options_.max_lines_per_frame =
+      std::max<std::size_t>(coalescing_options_.max_lines_per_frame, 1U);
+  frame_interval_ = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) /
+                    coalescing_options_.frames_per_second;
+  coalescing_ = true;
+}
+
+void Console::disable_coalescing() {
+  present_pending();
+  coalescing_ = false;
+}
+
+bool Console::coalescing() const noexcept {
+  return coalescing_;
+}
+
+ConsoleCounters Console::counters() const noexcept {
+  ConsoleCounters counters = counters_;
+  counters.bytes_sent = output_.stats().bytes_written;
+  counters.bytes_dropped = output_.stats().bytes_dropped;
+  if (async_writer_) {
+    counters.bytes_sent += async_writer_->bytes_written();
+    counters.bytes_dropped += async_writer_->bytes_dropped();
   }
+  return counters;
+}
 
-  std::vector<int> codes;
-  if (bold) {
-    codes.push_back(1);
+void Console::write(std::string_view text) {
+  counters_.bytes_submitted += text.size();
+  if (coalescing_) {
+    stage(text);
+    return;
   }
 
-  const int foreground_code = ansi_foreground(foreground);
-  const int background_code = ansi_background(background);
+  counters_.lines_submitted += static_cast<std::uint64_t>(std::ranges::count(text, '\n'));
+  output_.append(text);
+}
 
-  if (foreground_code >= 0) {
-    codes.push_back(foreground_code);
+void Console::write_control(std::string_view bytes) {
+  counters_.bytes_submitted += bytes.size();
+  // Lines staged earlier go out first so the order holds; the control bytes themselves are never
+  // counted as lines or elided.
+  if (coalescing_ && !pending_.empty()) {
+    present_pending();
   }
-  if (background_code >= 0) {
-    codes.push_back(background_code);
+  output_.append(bytes);
+}
+
+void Console::write_line_end() {
+  record(std::string_view{"\n"});
+  write(std::string_view{"\n"});
+}
+
+void Console::record(std::string_view text) {
+  if (scrollback_) {
+    scrollback_->append(text);
   }
+}
 
-  if (codes.empty()) {
-    return std::string{text};
+void Console::stage(std::string_view text) {
+  const std::size_t base = pending_.size();
+  pending_.append(text);
+
+  const std::size_t lines_before = pending_line_ends_.size();
+  for (std::size_t position = text.find('\n'); position != std::string_view::npos;
+       position = text.find('\n', position + 1U)) {
+    pending_line_ends_.push_back(base + position + 1U);
   }
 
-  std::ostringstream output;
-  output << "\033[";
-  for (std::size_t index = 0; index < codes.size(); ++index) {
-    if (index != 0U) {
-      output << ';';
-    }
-    output << codes[index];
+  const std::size_t new_lines = pending_line_ends_.size() - lines_before;
+  if (new_lines == 0U) {
+    return;
+  }
+  counters_.lines_submitted += new_lines;
+
+  // Trim in bulk once the backlog doubles so elision stays amortized O(1) per line.
+  if (pending_line_ends_.size() > 2U * coalescing_options_.max_lines_per_frame) {
+    elide_pending(coalescing_options_.max_lines_per_frame);
+  }
+
+  if (Clock::now() - last_present_ >= frame_interval_) {
+    present_pending();
   }
-  output << 'm' << text << "\033[0m";
-  return output.str();
 }
 
-void Console::flush() {
-  std::cout << std::flush;
+void Console::elide_pending(const std::size_t keep_lines) {
+  if (pending_line_ends_.size() <= keep_lines) {
+    return;
+  }
+
+  const std::size_t dropped = pending_line_ends_.size() - keep_lines;
+  const std::size_t cut = pending_line_ends_[dropped - 1U];
+
+  pending_.erase(0, cut);
+  pending_line_ends_.erase(pending_line_ends_.begin(),
+                           pending_line_ends_.begin() + static_cast<std::ptrdiff_t>(dropped));
+  for (std::size_t& line_end : pending_line_ends_) {
+    line_end -= cut;
+  }
+
+  pending_elided_ += dropped;
+  counters_.lines_elided += dropped;
 }
 
-void Console::clear_screen() {
-  if (ansi_enabled_) {
-    std::cout << "\033[2J\033[H";
-  } else {
-    constexpr int kFallbackNewlines = 48;
-    for (int i = 0; i < kFallbackNewlines; ++i) {
-      std::cout << '\n';
+void Console::present_pending() {
+  last_present_ = Clock::now();
+  if (pending_.empty()) {
+    return;
+  }
+
+  elide_pending(coalescing_options_.max_lines_per_frame);
+
+  if (pending_elided_ != 0U) {
+    std::string summary = "... " + std::to_string(pending_elided_) + " lines elided" +
+                          (scrollback_ ? " (kept in scrollback)" : "") + ", jumping to the last " +
+                          std::to_string(pending_line_ends_.size()) + " ...";
+    if (ansi_enabled_) {
+      const Style summary_style{Color::BrightBlack};
+      summary.insert(0, summary_style.prefix());
+      summary.append(Style::reset());
     }
+    output_.append(summary);
+    output_.append('\n');
+    pending_elided_ = 0;
   }
-  flush();
+
+  output_.append(pending_);
+  output_.flush();
+  pending_.clear();
+  pending_line_ends_.clear();
+  ++counters_.frames_presented;
 }
 
 bool Console::enable_virtual_terminal() {
@@ -110,32 +332,4 @@ bool Console::enable_virtual_terminal() {
 #endif
 }
 
-int Console::ansi_foreground(const Color color) {
-  const int value = static_cast<int>(color);
-  if (value < 0) {
-    return -1;
-  }
-  if (value <= 7) {
-    return 30 + value;
-  }
-  if (value <= 15) {
-    return 90 + (value - 8);
-  }
-  return -1;
-}
-
-int Console::ansi_background(const Color color) {
-  const int value = static_cast<int>(color);
-  if (value < 0) {
-    return -1;
-  }
-  if (value <= 7) {
-    return 40 + value;
-  }
-  if (value <= 15) {
-    return 100 + (value - 8);
-  }
-  return -1;
-}
-
 } // namespace opentui
@@ -0,0 +1,359 @@
+#include "opentui/display_width.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OPEN_TUI_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OPEN_TUI_HAS_SSE2 1
+#endif
+
+namespace opentui {
+namespace {
+
+struct CodepointRange {
+  char32_t first;
+  char32_t last;
+};
+
+// Nonspacing and enclosing marks, zero-width format characters and variation selectors.
+constexpr std::array<CodepointRange, 230> kZeroWidth{{
+    {0x0300, 0x036F},   {0x0483, 0x0489},   {0x0591, 0x05BD},   {0x05BF, 0x05BF},
+    {0x05C1, 0x05C2},   {0x05C4, 0x05C5},   {0x05C7, 0x05C7},   {0x0610, 0x061A},
+    {0x064B, 0x065F},   {0x0670, 0x0670},   {0x06D6, 0x06DC},   {0x06DF, 0x06E4},
+    {0x06E7, 0x06E8},   {0x06EA, 0x06ED},   {0x0711, 0x0711},   {0x0730, 0x074A},
+    {0x07A6, 0x07B0},   {0x07EB, 0x07F3},   {0x0816, 0x0819},   {0x081B, 0x0823},
+    {0x0825, 0x0827},   {0x0829, 0x082D},   {0x0859, 0x085B},   {0x08D3, 0x08E1},
+    {0x08E3, 0x0902},   {0x093A, 0x093A},   {0x093C, 0x093C},   {0x0941, 0x0948},
+    {0x094D, 0x094D},   {0x0951, 0x0957},   {0x0962, 0x0963},   {0x0981, 0x0981},
+    {0x09BC, 0x09BC},   {0x09C1, 0x09C4},   {0x09CD, 0x09CD},   {0x09E2, 0x09E3},
+    {0x0A01, 0x0A02},   {0x0A3C, 0x0A3C},   {0x0A41, 0x0A42},   {0x0A47, 0x0A48},
+    {0x0A4B, 0x0A4D},   {0x0A51, 0x0A51},   {0x0A70, 0x0A71},   {0x0A75, 0x0A75},
+    {0x0A81, 0x0A82},   {0x0ABC, 0x0ABC},   {0x0AC1, 0x0AC5},   {0x0AC7, 0x0AC8},
+    {0x0ACD, 0x0ACD},   {0x0AE2, 0x0AE3},   {0x0B01, 0x0B01},   {0x0B3C, 0x0B3C},
+    {0x0B3F, 0x0B3F},   {0x0B41, 0x0B44},   {0x0B4D, 0x0B4D},   {0x0B56, 0x0B56},
+    {0x0B62, 0x0B63},   {0x0B82, 0x0B82},   {0x0BC0, 0x0BC0},   {0x0BCD, 0x0BCD},
+    {0x0C00, 0x0C00},   {0x0C3E, 0x0C40},   {0x0C46, 0x0C48},   {0x0C4A, 0x0C4D},
+    {0x0C55, 0x0C56},   {0x0C62, 0x0C63},   {0x0CBC, 0x0CBC},   {0x0CCC, 0x0CCD},
+    {0x0CE2, 0x0CE3},   {0x0D41, 0x0D44},   {0x0D4D, 0x0D4D},   {0x0DCA, 0x0DCA},
+    {0x0DD2, 0x0DD4},   {0x0DD6, 0x0DD6},   {0x0E31, 0x0E31},   {0x0E34, 0x0E3A},
+    {0x0E47, 0x0E4E},   {0x0EB1, 0x0EB1},   {0x0EB4, 0x0EBC},   {0x0EC8, 0x0ECD},
+    {0x0F18, 0x0F19},   {0x0F35, 0x0F35},   {0x0F37, 0x0F37},   {0x0F39, 0x0F39},
+    {0x0F71, 0x0F7E},   {0x0F80, 0x0F84},   {0x0F86, 0x0F87},   {0x0F8D, 0x0FBC},
+    {0x0FC6, 0x0FC6},   {0x102D, 0x1030},   {0x1032, 0x1037},   {0x1039, 0x103A},
+    {0x103D, 0x103E},   {0x1058, 0x1059},   {0x105E, 0x1060},   {0x1071, 0x1074},
+    {0x1082, 0x1082},   {0x1085, 0x1086},   {0x108D, 0x108D},   {0x109D, 0x109D},
+    {0x1160, 0x11FF},   {0x135D, 0x135F},   {0x1712, 0x1714},   {0x1732, 0x1734},
+    {0x1752, 0x1753},   {0x1772, 0x1773},   {0x17B4, 0x17B5},   {0x17B7, 0x17BD},
+    {0x17C6, 0x17C6},   {0x17C9, 0x17D3},   {0x17DD, 0x17DD},   {0x180B, 0x180E},
+    {0x1885, 0x1886},   {0x18A9, 0x18A9},   {0x1920, 0x1922},   {0x1927, 0x1928},
+    {0x1932, 0x1932},   {0x1939, 0x193B},   {0x1A17, 0x1A18},   {0x1A1B, 0x1A1B},
+    {0x1A56, 0x1A56},   {0x1A58, 0x1A5E},   {0x1A60, 0x1A60},   {0x1A62, 0x1A62},
+    {0x1A65, 0x1A6C},   {0x1A73, 0x1A7C},   {0x1A7F, 0x1A7F},   {0x1AB0, 0x1B03},
+    {0x1B34, 0x1B34},   {0x1B36, 0x1B3A},   {0x1B3C, 0x1B3C},   {0x1B42, 0x1B42},
+    {0x1B6B, 0x1B73},   {0x1B80, 0x1B81},   {0x1BA2, 0x1BA5},   {0x1BA8, 0x1BA9},
+    {0x1BAB, 0x1BAD},   {0x1BE6, 0x1BE6},   {0x1BE8, 0x1BE9},   {0x1BED, 0x1BED},
+    {0x1BEF, 0x1BF1},   {0x1C2C, 0x1C33},   {0x1C36, 0x1C37},   {0x1CD0, 0x1CD2},
+    {0x1CD4, 0x1CE0},   {0x1CE2, 0x1CE8},   {0x1CED, 0x1CED},   {0x1CF4, 0x1CF4},
+    {0x1CF8, 0x1CF9},   {0x1DC0, 0x1DFF},   {0x200B, 0x200F},   {0x202A, 0x202E},
+    {0x2060, 0x2064},   {0x20D0, 0x20F0},   {0x2CEF, 0x2CF1},   {0x2D7F, 0x2D7F},
+    {0x2DE0, 0x2DFF},   {0x302A, 0x302D},   {0x3099, 0x309A},   {0xA66F, 0xA672},
+    {0xA674, 0xA67D},   {0xA69E, 0xA69F},   {0xA6F0, 0xA6F1},   {0xA802, 0xA802},
+    {0xA806, 0xA806},   {0xA80B, 0xA80B},   {0xA825, 0xA826},   {0xA8C4, 0xA8C5},
+    {0xA8E0, 0xA8F1},   {0xA926, 0xA92D},   {0xA947, 0xA951},   {0xA980, 0xA982},
+    {0xA9B3, 0xA9B3},   {0xA9B6, 0xA9B9},   {0xA9BC, 0xA9BC},   {0xA9E5, 0xA9E5},
+    {0xAA29, 0xAA2E},   {0xAA31, 0xAA32},   {0xAA35, 0xAA36},   {0xAA43, 0xAA43},
+    {0xAA4C, 0xAA4C},   {0xAA7C, 0xAA7C},   {0xAAB0, 0xAAB0},   {0xAAB2, 0xAAB4},
+    {0xAAB7, 0xAAB8},   {0xAABE, 0xAABF},   {0xAAC1, 0xAAC1},   {0xAAEC, 0xAAED},
+    {0xAAF6, 0xAAF6},   {0xABE5, 0xABE5},   {0xABE8, 0xABE8},   {0xABED, 0xABED},
+    {0xD7B0, 0xD7FF},   {0xFB1E, 0xFB1E},   {0xFE00, 0xFE0F},   {0xFE20, 0xFE2F},
+    {0xFEFF, 0xFEFF},   {0xFFF9, 0xFFFB},   {0x101FD, 0x101FD}, {0x102E0, 0x102E0},
+    {0x10376, 0x1037A}, {0x10A01, 0x10A0F}, {0x10A38, 0x10A3F}, {0x10AE5, 0x10AE6},
+    {0x10D24, 0x10D27}, {0x10F46, 0x10F50}, {0x11001, 0x11001}, {0x11038, 0x11046},
+    {0x1107F, 0x11081}, {0x110B3, 0x110B6}, {0x110B9, 0x110BA}, {0x11100, 0x11102},
+    {0x11127, 0x1112B}, {0x1112D, 0x11134}, {0x11173, 0x11173}, {0x11180, 0x11181},
+    {0x111B6, 0x111BE}, {0x1D167, 0x1D169}, {0x1D173, 0x1D182}, {0x1D185, 0x1D18B},
+    {0x1D1AA, 0x1D1AD}, {0x1D242, 0x1D244}, {0x1E000, 0x1E02A}, {0x1E130, 0x1E136},
+    {0x1E2EC, 0x1E2EF}, {0x1E8D0, 0x1E8D6}, {0x1E944, 0x1E94A}, {0xE0001, 0xE0001},
+    {0xE0020, 0xE007F}, {0xE0100, 0xE01EF},
+}};
+
+// East Asian Wide and Fullwidth characters plus default emoji presentation.
+constexpr std::array<CodepointRange, 118> kWide{{
+    {0x1100, 0x115F},   {0x231A, 0x231B},   {0x2329, 0x232A},   {0x23E9, 0x23EC},
+    {0x23F0, 0x23F0},   {0x23F3, 0x23F3},   {0x25FD, 0x25FE},   {0x2614, 0x2615},
+    {0x2648, 0x2653},   {0x267F, 0x267F},   {0x2693, 0x2693},   {0x26A1, 0x26A1},
+    {0x26AA, 0x26AB},   {0x26BD, 0x26BE},   {0x26C4, 0x26C5},   {0x26CE, 0x26CE},
+    {0x26D4, 0x26D4},   {0x26EA, 0x26EA},   {0x26F2, 0x26F3},   {0x26F5, 0x26F5},
+    {0x26FA, 0x26FA},   {0x26FD, 0x26FD},   {0x2705, 0x2705},   {0x270A, 0x270B},
+    {0x2728, 0x2728},   {0x274C, 0x274C},   {0x274E, 0x274E},   {0x2753, 0x2755},
+    {0x2757, 0x2757},   {0x2795, 0x2797},   {0x27B0, 0x27B0},   {0x27BF, 0x27BF},
+    {0x2B1B, 0x2B1C},   {0x2B50, 0x2B50},   {0x2B55, 0x2B55},   {0x2E80, 0x2E99},
+    {0x2E9B, 0x2EF3},   {0x2F00, 0x2FD5},   {0x2FF0, 0x2FFB},   {0x3000, 0x3029},
+    {0x302E, 0x303E},   {0x3041, 0x3096},   {0x309B, 0x30FF},   {0x3105, 0x312F},
+    {0x3131, 0x318E},   {0x3190, 0x31E3},   {0x31F0, 0x321E},   {0x3220, 0x3247},
+    {0x3250, 0x4DBF},   {0x4E00, 0xA48C},   {0xA490, 0xA4C6},   {0xA960, 0xA97C},
+    {0xAC00, 0xD7A3},   {0xF900, 0xFAFF},   {0xFE10, 0xFE19},   {0xFE30, 0xFE52},
+    {0xFE54, 0xFE66},   {0xFE68, 0xFE6B},   {0xFF00, 0xFF60},   {0xFFE0, 0xFFE6},
+    {0x16FE0, 0x16FE4}, {0x16FF0, 0x16FF1}, {0x17000, 0x187F7}, {0x18800, 0x18CD5},
+    {0x18D00, 0x18D08}, {0x1AFF0, 0x1AFFE}, {0x1B000, 0x1B122}, {0x1B150, 0x1B152},
+    {0x1B164, 0x1B167}, {0x1B170, 0x1B2FB}, {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF},
+    {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F202}, {0x1F210, 0x1F23B},
+    {0x1F240, 0x1F248}, {0x1F250, 0x1F251}, {0x1F260, 0x1F265}, {0x1F300, 0x1F320},
+    {0x1F32D, 0x1F335}, {0x1F337, 0x1F37C}, {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA},
+    {0x1F3CF, 0x1F3D3}, {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4}, {0x1F3F8, 0x1F43E},
+    {0x1F440, 0x1F440}, {0x1F442, 0x1F4FC}, {0x1F4FF, 0x1F53D}, {0x1F54B, 0x1F54E},
+    {0x1F550, 0x1F567}, {0x1F57A, 0x1F57A}, {0x1F595, 0x1F596}, {0x1F5A4, 0x1F5A4},
+    {0x1F5FB, 0x1F64F}, {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC}, {0x1F6D0, 0x1F6D2},
+    {0x1F6D5, 0x1F6D7}, {0x1F6DC, 0x1F6DF}, {0x1F6EB, 0x1F6EC}, {0x1F6F4, 0x1F6FC},
+    {0x1F7E0, 0x1F7EB}, {0x1F7F0, 0x1F7F0}, {0x1F90C, 0x1F93A}, {0x1F93C, 0x1F945},
+    {0x1F947, 0x1F9FF}, {0x1FA70, 0x1FA7C}, {0x1FA80, 0x1FA88}, {0x1FA90, 0x1FABD},
+    {0x1FABF, 0x1FAC5}, {0x1FACE, 0x1FADB}, {0x1FAE0, 0x1FAE8}, {0x1FAF0, 0x1FAF8},
+    {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD},
+}};
+
+template <std::size_t N>
+[[nodiscard]] constexpr bool sorted_and_disjoint(const std::array<CodepointRange, N>& ranges) {
+  for (std::size_t index = 0; index < N; ++index) {
+    if (ranges[index].first > ranges[index].last ||
+        (index != 0U && ranges[index - 1U].last >= ranges[index].first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static_assert(sorted_and_disjoint(kZeroWidth));
+static_assert(sorted_and_disjoint(kWide));
+
+template <std::size_t N>
+[[nodiscard]] bool in_table(const std::array<CodepointRange, N>& ranges,
+                            const char32_t codepoint) {
+  if (codepoint < ranges.front().first || codepoint > ranges.back().last) {
+    return false;
+  }
+  const auto range = std::ranges::upper_bound(ranges, codepoint, {}, &CodepointRange::first);
+  return range != ranges.begin() && codepoint <= std::prev(range)->last;
+}
+
+constexpr char kEscape = '\033';
+
+// Counts the leading bytes in [0x20, 0x7E], examining at most `limit` bytes.
+[[nodiscard]] std::size_t printable_ascii_run(const char* data, const std::size_t limit) noexcept {
+  std::size_t count = 0;
+
+#if defined(OPEN_TUI_HAS_AVX2)
+  const __m256i space_minus_one = _mm256_set1_epi8(0x1F);
+  const __m256i delete_char = _mm256_set1_epi8(0x7F);
+  while (limit - count >= 32U) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + count));
+    // Signed compares: bytes >= 0x80 are negative and therefore fail the lower bound.
+    const __m256i printable = _mm256_and_si256(_mm256_cmpgt_epi8(block, space_minus_one),
+                                               _mm256_cmpgt_epi8(delete_char, block));
+    const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(printable));
+    if (mask != 0xFFFFFFFFU) {
+      return count + static_cast<std::size_t>(std::countr_one(mask));
+    }
+    count += 32U;
+  }
+#endif
+
+#if defined(OPEN_TUI_HAS_SSE2)
+  const __m128i space_minus_one = _mm_set1_epi8(0x1F);
+  const __m128i delete_char = _mm_set1_epi8(0x7F);
+  while (limit - count >= 16U) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + count));
+    const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(block, space_minus_one),
+                                            _mm_cmplt_epi8(block, delete_char));
+    const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(printable));
+    if (mask != 0xFFFFU) {
+      return count + static_cast<std::size_t>(std::countr_one(mask));
+    }
+    count += 16U;
+  }
+#endif
+
+  while (count < limit) {
+    const auto byte = static_cast<unsigned char>(data[count]);
+    if (byte < 0x20U || byte > 0x7EU) {
+      break;
+    }
+    ++count;
+  }
+  return count;
+}
+
+// Length of the escape sequence starting at `index` (which holds ESC).
+[[nodiscard]] std::size_t escape_length(std::string_view text, const std::size_t index) noexcept {
+  if (index + 1U >= text.size()) {
+    return 1U;
+  }
+
+  const char introducer = text[index + 1U];
+  if (introducer == '[') {
+    std::size_t position = index + 2U;
+    while (position < text.size()) {
+      const auto byte = static_cast<unsigned char>(text[position]);
+      ++position;
+      if (byte >= 0x40U && byte <= 0x7EU) {
+        break;
+      }
+    }
+    return position - index;
+  }
+
+  if (introducer == ']') {
+    std::size_t position = index + 2U;
+    while (position < text.size()) {
+      if (text[position] == '\a') {
+        return position + 1U - index;
+      }
+      if (text[position] == kEscape && position + 1U < text.size() &&
+          text[position + 1U] == '\\') {
+        return position + 2U - index;
+      }
+      ++position;
+    }
+    return position - index;
+  }
+
+  return 2U;
+}
+
+struct Measurement {
+  std::size_t bytes;
+  std::size_t columns;
+};
+
+[[nodiscard]] Measurement measure(std::string_view text, const std::size_t limit) noexcept {
+  std::size_t index = 0;
+  std::size_t columns = 0;
+
+  while (index < text.size()) {
+    const std::size_t run =
+        printable_ascii_run(text.data() + index, std::min(text.size() - index, limit - columns));
+    index += run;
+    columns += run;
+    if (index >= text.size()) {
+      break;
+    }
+
+    if (text[index] == kEscape) {
+      index += escape_length(text, index);
+      continue;
+    }
+
+    const DecodedCodepoint decoded = decode_utf8(text, index);
+    const std::size_t width = codepoint_width(decoded.codepoint);
+    if (columns + width > limit) {
+      break;
+    }
+    columns += width;
+    index += decoded.length;
+  }
+
+  return {.bytes = std::min(index, text.size()), .columns = columns};
+}
+
+} // namespace
+
+DecodedCodepoint decode_utf8(std::string_view text, const std::size_t index) noexcept {
+  constexpr char32_t kReplacement = 0xFFFD;
+  const auto lead = static_cast<unsigned char>(text[index]);
+  if (lead < 0x80U) {
+    return {lead, 1U};
+  }
+
+  std::size_t length = 0;
+  char32_t codepoint = 0;
+  if ((lead & 0xE0U) == 0xC0U) {
+    length = 2U;
+    codepoint = lead & 0x1FU;
+  } else if ((lead & 0xF0U) == 0xE0U) {
+    length = 3U;
+    codepoint = lead & 0x0FU;
+  } else if ((lead & 0xF8U) == 0xF0U) {
+    length = 4U;
+    codepoint = lead & 0x07U;
+  } else {
+    return {kReplacement, 1U};
+  }
+
+  if (index + length > text.size()) {
+    return {kReplacement, 1U};
+  }
+
+  for (std::size_t offset = 1; offset < length; ++offset) {
+    const auto continuation = static_cast<unsigned char>(text[index + offset]);
+    if ((continuation & 0xC0U) != 0x80U) {
+      return {kReplacement, 1U};
+    }
+    codepoint = (codepoint << 6U) | (continuation & 0x3FU);
+  }
+
+  return {codepoint, length};
+}
+
+std::size_t codepoint_width(const char32_t codepoint) noexcept {
+  if (codepoint < 0x20U || (codepoint >= 0x7FU && codepoint < 0xA0U)) {
+    return 0U;
+  }
+  if (codepoint < 0x300U) {
+    return 1U;
+  }
+  if (in_table(kZeroWidth, codepoint)) {
+    return 0U;
+  }
+  if (in_table(kWide, codepoint)) {
+    return 2U;
+  }
+  return 1U;
+}
+
+std::size_t display_width(std::string_view text) noexcept {
+  return measure(text, text.size()).columns;
+}
+
+std::size_t prefix_bytes_for_width(std::string_view text, const std::size_t width) noexcept {
+  return measure(text, width).bytes;
+}
+
+std::string truncate_to_width(std::string_view text, const std::size_t width,
+                              std::string_view ellipsis) {
+  const Measurement whole = measure(text, width);
+  if (whole.bytes == text.size()) {
+    return std::string{text};
+  }
+
+  const std::size_t ellipsis_width = display_width(ellipsis);
+  if (ellipsis_width > width) {
+    return std::string{text.substr(0, whole.bytes)};
+  }
+
+  std::string result{text.substr(0, prefix_bytes_for_width(text, width - ellipsis_width))};
+  result.append(ellipsis);
+  return result;
+}
+
+std::string pad_to_width(std::string_view text, const std::size_t width) {
+  std::string result{text};
+  const std::size_t current = display_width(text);
+  if (current < width) {
+    result.append(width - current, ' ');
+  }
+  return result;
+}
+
+std::string fit_to_width(std::string_view text, const std::size_t width,
+                         std::string_view ellipsis) {
+  return pad_to_width(truncate_to_width(text, width, ellipsis), width);
+}
+
+} // namespace opentui
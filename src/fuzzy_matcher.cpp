@@ -0,0 +1,575 @@
+#include "opentui/fuzzy_matcher.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OPEN_TUI_HAS_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OPEN_TUI_HAS_SSE2 1
+#endif
+
+namespace opentui {
+namespace {
+
+enum class CharacterClass : std::uint8_t {
+  White,
+  NonWord,
+  Delimiter,
+  Lower,
+  Upper,
+  Letter,
+  Number,
+};
+
+constexpr std::size_t kClassCount = 7;
+
+// Scoring follows fzf: every matched character earns kMatch, gaps cost kGapStart for their first
+// character and kGapExtension for each further one, and boundary bonuses reward matches where a
+// word starts.
+constexpr int kMatch = 16;
+constexpr int kGapStart = -3;
+constexpr int kGapExtension = -1;
+constexpr int kBoundaryBonus = kMatch / 2;
+constexpr int kWhiteBoundaryBonus = kBoundaryBonus + 2;
+constexpr int kDelimiterBoundaryBonus = kBoundaryBonus + 1;
+constexpr int kNonWordBonus = kBoundaryBonus;
+constexpr int kCamelCaseBonus = kBoundaryBonus + kGapExtension;
+constexpr int kConsecutiveBonus = -(kGapStart + kGapExtension);
+constexpr int kFirstCharacterMultiplier = 2;
+
+// Letters and digits get a bit each; everything else shares the remaining 28.
+constexpr unsigned kLetterBits = 26;
+constexpr unsigned kDigitBits = 10;
+constexpr unsigned kOtherBits = 64 - kLetterBits - kDigitBits;
+
+constexpr std::array<CharacterClass, 256> kClasses = []() {
+  std::array<CharacterClass, 256> classes{};
+  for (std::size_t byte = 0; byte < classes.size(); ++byte) {
+    const auto character = static_cast<char>(byte);
+    if (byte >= 0x80U) {
+      classes[byte] = CharacterClass::Letter;
+    } else if (character >= 'a' && character <= 'z') {
+      classes[byte] = CharacterClass::Lower;
+    } else if (character >= 'A' && character <= 'Z') {
+      classes[byte] = CharacterClass::Upper;
+    } else if (character >= '0' && character <= '9') {
+      classes[byte] = CharacterClass::Number;
+    } else if (character == ' ' || (character >= '\t' && character <= '\r')) {
+      classes[byte] = CharacterClass::White;
+    } else if (character == '/' || character == ',' || character == ':' || character == ';' ||
+               character == '|') {
+      classes[byte] = CharacterClass::Delimiter;
+    } else {
+      classes[byte] = CharacterClass::NonWord;
+    }
+  }
+  return classes;
+}();
+
+[[nodiscard]] constexpr bool is_word(const CharacterClass character_class) {
+  return character_class >= CharacterClass::Lower;
+}
+
+[[nodiscard]] constexpr int bonus_for(const CharacterClass previous,
+                                      const CharacterClass current) {
+  if (is_word(current)) {
+    if (previous == CharacterClass::White) {
+      return kWhiteBoundaryBonus;
+    }
+    if (previous == CharacterClass::Delimiter) {
+      return kDelimiterBoundaryBonus;
+    }
+    if (previous == CharacterClass::NonWord) {
+      return kBoundaryBonus;
+    }
+  }
+  if ((previous == CharacterClass::Lower && current == CharacterClass::Upper) ||
+      (previous != CharacterClass::Number && current == CharacterClass::Number)) {
+    return kCamelCaseBonus;
+  }
+  if (current == CharacterClass::NonWord || current == CharacterClass::Delimiter) {
+    return kNonWordBonus;
+  }
+  if (current == CharacterClass::White) {
+    return kWhiteBoundaryBonus;
+  }
+  return 0;
+}
+
+constexpr std::array<std::array<int, kClassCount>, kClassCount> kBonuses = []() {
+  std::array<std::array<int, kClassCount>, kClassCount> bonuses{};
+  for (std::size_t previous = 0; previous < kClassCount; ++previous) {
+    for (std::size_t current = 0; current < kClassCount; ++current) {
+      bonuses[previous][current] = bonus_for(static_cast<CharacterClass>(previous),
+                                             static_cast<CharacterClass>(current));
+    }
+  }
+  return bonuses;
+}();
+
+constexpr std::array<std::uint8_t, 256> kMaskBits = []() {
+  std::array<std::uint8_t, 256> bits{};
+  for (std::size_t byte = 0; byte < bits.size(); ++byte) {
+    const auto character = static_cast<char>(byte);
+    if (character >= 'a' && character <= 'z') {
+      bits[byte] = static_cast<std::uint8_t>(character - 'a');
+    } else if (character >= 'A' && character <= 'Z') {
+      bits[byte] = static_cast<std::uint8_t>(character - 'A');
+    } else if (character >= '0' && character <= '9') {
+      bits[byte] = static_cast<std::uint8_t>(kLetterBits + static_cast<unsigned>(character - '0'));
+    } else {
+      bits[byte] = static_cast<std::uint8_t>(kLetterBits + kDigitBits + byte % kOtherBits);
+    }
+  }
+  return bits;
+}();
+
+[[nodiscard]] CharacterClass class_of(const char character) noexcept {
+  return kClasses[static_cast<unsigned char>(character)];
+}
+
+[[nodiscard]] char fold(const char character) noexcept {
+  return character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a')
+                                               : character;
+}
+
+// Position of the first `first` or `second` byte at or after `from`, or the size of `text`.
+[[nodiscard]] std::size_t find_either(std::string_view text, std::size_t from, const char first,
+                                      const char second) noexcept {
+#if defined(OPEN_TUI_HAS_SSE2)
+  const __m128i firsts = _mm_set1_epi8(first);
+  const __m128i seconds = _mm_set1_epi8(second);
+  for (; text.size() - from >= 16U; from += 16U) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + from));
+    const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(block, firsts), _mm_cmpeq_epi8(block, seconds));
+    const auto bits = static_cast<unsigned>(_mm_movemask_epi8(hit));
+    if (bits != 0U) {
+      return from + static_cast<std::size_t>(std::countr_zero(bits));
+    }
+  }
+#endif
+  for (; from < text.size(); ++from) {
+    if (text[from] == first || text[from] == second) {
+      break;
+    }
+  }
+  return from;
+}
+
+struct Window {
+  std::size_t start;
+  std::size_t end;
+};
+
+// The first occurrence of the whole pattern bounds the match on the right; walking back from there
+// finds the shortest window ending at that point. `alternates` holds the other case of each
+// pattern character that may match it.
+[[nodiscard]] std::optional<Window> scan_window(std::string_view candidate,
+                                                std::string_view pattern,
+                                                std::string_view alternates) noexcept {
+  std::size_t end = 0;
+  for (std::size_t matched = 0; matched < pattern.size(); ++matched) {
+    end = find_either(candidate, end, pattern[matched], alternates[matched]);
+    if (end == candidate.size()) {
+      return std::nullopt;
+    }
+    ++end;
+  }
+
+  std::size_t start = end;
+  for (std::size_t matched = pattern.size(); matched > 0U;) {
+    --start;
+    if (candidate[start] == pattern[matched - 1U] || candidate[start] == alternates[matched - 1U]) {
+      --matched;
+    }
+  }
+  return Window{.start = start, .end = end};
+}
+
+#if defined(OPEN_TUI_HAS_SSE2)
+// Shorter candidates, which are most of them, find the same window without a branch per byte:
+// each pattern character becomes a bit mask of the positions where it occurs, and the greedy scans
+// reduce to a few bit operations per character.
+constexpr std::size_t kMaskedCandidateMinimum = 16;
+constexpr std::size_t kMaskedCandidateMaximum = 64;
+constexpr std::size_t kMaskedPatternMaximum = 16;
+
+// Bit n is set when candidate[n] is `first` or `second`. The last block is loaded so that it ends
+// with the candidate, overlapping the previous one rather than reading past the end.
+[[nodiscard]] std::uint64_t positions_of(std::string_view candidate, const char first,
+                                         const char second) noexcept {
+  const __m128i firsts = _mm_set1_epi8(first);
+  const __m128i seconds = _mm_set1_epi8(second);
+  std::uint64_t positions = 0;
+  for (std::size_t offset = 0; offset < candidate.size(); offset += 16U) {
+    const std::size_t block_offset = std::min(offset, candidate.size() - 16U);
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(candidate.data() + block_offset));
+    const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(block, firsts), _mm_cmpeq_epi8(block, seconds));
+    positions |= static_cast<std::uint64_t>(static_cast<unsigned>(_mm_movemask_epi8(hit)))
+                 << block_offset;
+  }
+  return positions;
+}
+
+[[nodiscard]] std::optional<Window> masked_window(std::string_view candidate,
+                                                  std::string_view pattern,
+                                                  std::string_view alternates) noexcept {
+  std::array<std::uint64_t, kMaskedPatternMaximum> positions{};
+  std::uint64_t allowed = ~std::uint64_t{0};
+  std::size_t end = 0;
+  for (std::size_t matched = 0; matched < pattern.size(); ++matched) {
+    positions[matched] = positions_of(candidate, pattern[matched], alternates[matched]);
+    const std::uint64_t hits = positions[matched] & allowed;
+    if (hits == 0U) {
+      return std::nullopt;
+    }
+    end = static_cast<std::size_t>(std::countr_zero(hits)) + 1U;
+    allowed = end == 64U ? 0U : ~std::uint64_t{0} << end;
+  }
+
+  std::uint64_t below = end == 64U ? ~std::uint64_t{0} : (std::uint64_t{1} << end) - 1U;
+  std::size_t start = end;
+  for (std::size_t matched = pattern.size(); matched > 0U; --matched) {
+    start = 63U - static_cast<std::size_t>(std::countl_zero(positions[matched - 1U] & below));
+    below = (std::uint64_t{1} << start) - 1U;
+  }
+  return Window{.start = start, .end = end};
+}
+#endif
+
+struct Ranked {
+  int score;
+  std::size_t length;
+  std::size_t index;
+};
+
+// True when `left` should be listed before `right`.
+[[nodiscard]] bool ranks_before(const Ranked& left, const Ranked& right) noexcept {
+  if (left.score != right.score) {
+    return left.score > right.score;
+  }
+  if (left.length != right.length) {
+    return left.length < right.length;
+  }
+  return left.index < right.index;
+}
+
+template <typename Text>
+[[nodiscard]] std::vector<std::string> filter_and_rank(std::string_view pattern,
+                                                       std::span<const Text> candidates) {
+  if (pattern.empty()) {
+    return std::vector<std::string>(candidates.begin(), candidates.end());
+  }
+
+  const FuzzyMatcher matcher(pattern);
+  std::vector<Ranked> ranked;
+  for (std::size_t index = 0; index < candidates.size(); ++index) {
+    const std::string_view candidate = candidates[index];
+    if (const std::optional<int> score = matcher.score(candidate)) {
+      ranked.push_back(Ranked{.score = *score, .length = candidate.size(), .index = index});
+    }
+  }
+  std::ranges::sort(ranked, ranks_before);
+
+  std::vector<std::string> results;
+  results.reserve(ranked.size());
+  for (const Ranked& match : ranked) {
+    results.emplace_back(candidates[match.index]);
+  }
+  return results;
+}
+
+// Calls `visit` with the index of every mask that contains all of `required`, in order.
+template <typename Visit>
+void for_each_superset(const std::vector<std::uint64_t>& masks, const std::uint64_t required,
+                       const Visit& visit) {
+  const std::uint64_t* data = masks.data();
+  const std::size_t count = masks.size();
+  std::size_t index = 0;
+
+#if defined(OPEN_TUI_HAS_AVX2)
+  const __m256i wanted = _mm256_set1_epi64x(static_cast<long long>(required));
+  for (; count - index >= 4U; index += 4U) {
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+    const __m256i hit = _mm256_cmpeq_epi64(_mm256_and_si256(block, wanted), wanted);
+    auto bits = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(hit)));
+    while (bits != 0U) {
+      visit(index + static_cast<std::size_t>(std::countr_zero(bits)));
+      bits &= bits - 1U;
+    }
+  }
+#elif defined(OPEN_TUI_HAS_SSE2)
+  const __m128i wanted = _mm_set1_epi64x(static_cast<long long>(required));
+  for (; count - index >= 2U; index += 2U) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+    // SSE2 has no 64-bit compare: both 32-bit halves of a lane have to be equal.
+    const __m128i halves = _mm_cmpeq_epi32(_mm_and_si128(block, wanted), wanted);
+    const __m128i hit = _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+    auto bits = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(hit)));
+    while (bits != 0U) {
+      visit(index + static_cast<std::size_t>(std::countr_zero(bits)));
+      bits &= bits - 1U;
+    }
+  }
+#endif
+
+  for (; index < count; ++index) {
+    if ((data[index] & required) == required) {
+      visit(index);
+    }
+  }
+}
+
+} // namespace
+
+std::uint64_t character_set_mask(std::string_view text) noexcept {
+  std::uint64_t mask = 0;
+  for (const char character : text) {
+    mask |= std::uint64_t{1} << kMaskBits[static_cast<unsigned char>(character)];
+  }
+  return mask;
+}
+
+FuzzyMatcher::FuzzyMatcher(std::string_view pattern)
+    : pattern_(pattern), required_characters_(character_set_mask(pattern)) {
+  const bool case_sensitive = std::ranges::any_of(
+      pattern, [](const char character) { return class_of(character) == CharacterClass::Upper; });
+  for (std::size_t byte = 0; byte < comparable_.size(); ++byte) {
+    const auto character = static_cast<char>(byte);
+    comparable_[byte] = case_sensitive ? character : fold(character);
+  }
+  if (!case_sensitive) {
+    std::ranges::transform(pattern_, pattern_.begin(), fold);
+  }
+  alternates_ = pattern_;
+  if (!case_sensitive) {
+    std::ranges::transform(alternates_, alternates_.begin(), [](const char character) {
+      return class_of(character) == CharacterClass::Lower ? static_cast<char>(character - 'a' + 'A')
+                                                          : character;
+    });
+  }
+}
+
+std::string_view FuzzyMatcher::pattern() const noexcept {
+  return pattern_;
+}
+
+std::uint64_t FuzzyMatcher::required_characters() const noexcept {
+  return required_characters_;
+}
+
+int FuzzyMatcher::best_possible_score() const noexcept {
+  if (pattern_.empty()) {
+    return 0;
+  }
+  const auto length = static_cast<int>(pattern_.size());
+  return length * kMatch + (kFirstCharacterMultiplier + length - 1) * kWhiteBoundaryBonus;
+}
+
+bool FuzzyMatcher::same(const char pattern_character,
+                        const char candidate_character) const noexcept {
+  return pattern_character == comparable_[static_cast<unsigned char>(candidate_character)];
+}
+
+bool FuzzyMatcher::matches(std::string_view candidate) const noexcept {
+  std::size_t from = 0;
+  for (std::size_t matched = 0; matched < pattern_.size(); ++matched) {
+    from = find_either(candidate, from, pattern_[matched], alternates_[matched]);
+    if (from == candidate.size()) {
+      return false;
+    }
+    ++from;
+  }
+  return true;
+}
+
+std::optional<int> FuzzyMatcher::score(std::string_view candidate,
+                                       const int minimum) const noexcept {
+  if (pattern_.empty()) {
+    return 0;
+  }
+
+  std::optional<Window> window;
+#if defined(OPEN_TUI_HAS_SSE2)
+  if (candidate.size() >= kMaskedCandidateMinimum && candidate.size() <= kMaskedCandidateMaximum &&
+      pattern_.size() <= kMaskedPatternMaximum) {
+    window = masked_window(candidate, pattern_, alternates_);
+  } else {
+    window = scan_window(candidate, pattern_, alternates_);
+  }
+#else
+  window = scan_window(candidate, pattern_, alternates_);
+#endif
+  if (!window.has_value()) {
+    return std::nullopt;
+  }
+  const auto [start, end] = *window;
+
+  // Bound the score before computing it: the first character's bonus is known now, every later one
+  // is at most kWhiteBoundaryBonus, and each unmatched byte in the window costs at least one point,
+  // the first of them three.
+  CharacterClass previous = start == 0U ? CharacterClass::White : class_of(candidate[start - 1U]);
+  const int first_character_bonus = kBonuses[static_cast<std::size_t>(previous)]
+                                            [static_cast<std::size_t>(class_of(candidate[start]))];
+  const auto gap = static_cast<long long>(end - start - pattern_.size());
+  const long long gap_penalty = gap == 0 ? 0 : gap + (kGapExtension - kGapStart);
+  const long long lost_first_bonus =
+      (kWhiteBoundaryBonus - first_character_bonus) * kFirstCharacterMultiplier;
+  if (best_possible_score() - lost_first_bonus - gap_penalty < minimum) {
+    return std::nullopt;
+  }
+
+  int score = 0;
+  int first_bonus = 0;
+  std::size_t consecutive = 0;
+  bool in_gap = false;
+  std::size_t matched = 0;
+  for (std::size_t index = start; index < end; ++index) {
+    const CharacterClass current = class_of(candidate[index]);
+    if (matched < pattern_.size() && same(pattern_[matched], candidate[index])) {
+      int bonus = kBonuses[static_cast<std::size_t>(previous)][static_cast<std::size_t>(current)];
+      if (consecutive == 0U) {
+        first_bonus = bonus;
+      } else {
+        // A run keeps the bonus of the boundary it started on.
+        if (bonus >= kBoundaryBonus && bonus > first_bonus) {
+          first_bonus = bonus;
+        }
+        bonus = std::max({bonus, first_bonus, kConsecutiveBonus});
+      }
+
+      score += kMatch + (matched == 0U ? bonus * kFirstCharacterMultiplier : bonus);
+      in_gap = false;
+      ++consecutive;
+      ++matched;
+    } else {
+      score += in_gap ? kGapExtension : kGapStart;
+      in_gap = true;
+      consecutive = 0;
+      first_bonus = 0;
+    }
+    previous = current;
+  }
+  return score;
+}
+
+std::vector<std::string> fuzzy_filter(std::string_view pattern,
+                                      std::span<const std::string> candidates) {
+  return filter_and_rank(pattern, candidates);
+}
+
+std::vector<std::string> fuzzy_filter(std::string_view pattern,
+                                      std::span<const std::string_view> candidates) {
+  return filter_and_rank(pattern, candidates);
+}
+
+FuzzyIndex::FuzzyIndex(std::span<const std::string> candidates) {
+  assign(candidates);
+}
+
+void FuzzyIndex::assign(std::span<const std::string> candidates) {
+  text_.clear();
+  entries_.clear();
+  masks_.clear();
+  std::size_t bytes = 0;
+  for (const std::string& candidate : candidates) {
+    bytes += candidate.size();
+  }
+  text_.reserve(bytes);
+  entries_.reserve(candidates.size());
+  masks_.reserve(candidates.size());
+  for (const std::string& candidate : candidates) {
+    add(candidate);
+  }
+}
+
+void FuzzyIndex::add(std::string_view candidate) {
+  entries_.push_back(Entry{.offset = text_.size(), .length = candidate.size()});
+  masks_.push_back(character_set_mask(candidate));
+  text_.append(candidate);
+}
+
+std::size_t FuzzyIndex::size() const noexcept {
+  return entries_.size();
+}
+
+std::string_view FuzzyIndex::operator[](const std::size_t index) const {
+  const Entry& entry = entries_[index];
+  return std::string_view{text_}.substr(entry.offset, entry.length);
+}
+
+std::vector<FuzzyMatch> FuzzyIndex::search(std::string_view pattern, const std::size_t limit,
+                                           std::size_t* const matching) const {
+  std::vector<FuzzyMatch> matches;
+  if (pattern.empty()) {
+    const std::size_t count = std::min(limit, entries_.size());
+    for (std::size_t index = 0; index < count; ++index) {
+      matches.push_back(FuzzyMatch{.index = index, .score = 0});
+    }
+    if (matching != nullptr) {
+      *matching = entries_.size();
+    }
+    return matches;
+  }
+  if (limit == 0U && matching == nullptr) {
+    return matches;
+  }
+
+  // A heap ordered so that its front is the weakest of the best matches found so far.
+  const FuzzyMatcher matcher(pattern);
+  const int best_possible = matcher.best_possible_score();
+  std::vector<Ranked> best;
+  best.reserve(std::min(limit, entries_.size()));
+  std::size_t matched = 0;
+  for_each_superset(masks_, matcher.required_characters(), [&](const std::size_t index) {
+    const std::string_view candidate = (*this)[index];
+    // Candidates arrive in index order, so one at least as long as the weakest kept match has to
+    // outscore it, and once that match has the best possible score nothing that long can.
+    int minimum = std::numeric_limits<int>::min();
+    bool ranked_out = limit == 0U;
+    if (!ranked_out && best.size() == limit) {
+      const bool needs_more = candidate.size() >= best.front().length;
+      ranked_out = needs_more && best.front().score == best_possible;
+      minimum = best.front().score + (needs_more ? 1 : 0);
+    }
+    const std::optional<int> score = ranked_out ? std::nullopt : matcher.score(candidate, minimum);
+    // Unless it was ranked out or held to a minimum, a candidate without a score does not match.
+    const bool bounded = ranked_out || minimum != std::numeric_limits<int>::min();
+    if (matching != nullptr && (score.has_value() || (bounded && matcher.matches(candidate)))) {
+      ++matched;
+    }
+    if (!score.has_value()) {
+      return;
+    }
+
+    const Ranked ranked{.score = *score, .length = candidate.size(), .index = index};
+    if (best.size() < limit) {
+      best.push_back(ranked);
+      std::ranges::push_heap(best, ranks_before);
+    } else if (ranks_before(ranked, best.front())) {
+      std::ranges::pop_heap(best, ranks_before);
+      best.back() = ranked;
+      std::ranges::push_heap(best, ranks_before);
+    }
+  });
+
+  std::ranges::sort_heap(best, ranks_before);
+  matches.reserve(best.size());
+  for (const Ranked& ranked : best) {
+    matches.push_back(FuzzyMatch{.index = ranked.index, .score = ranked.score});
+  }
+  if (matching != nullptr) {
+    *matching = matched;
+  }
+  return matches;
+}
+
+} // namespace opentui
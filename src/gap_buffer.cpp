@@ -0,0 +1,190 @@
+#include "opentui/gap_buffer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include "opentui/display_width.hpp"
+
+namespace opentui {
+namespace {
+
+constexpr std::size_t kMinimumGap = 64;
+
+[[nodiscard]] bool is_continuation_byte(const char byte) noexcept {
+  return (static_cast<unsigned char>(byte) & 0xC0U) == 0x80U;
+}
+
+[[nodiscard]] std::size_t previous_codepoint_start(std::string_view text, std::size_t offset) {
+  while (offset > 0U) {
+    --offset;
+    if (!is_continuation_byte(text[offset])) {
+      break;
+    }
+  }
+  return offset;
+}
+
+} // namespace
+
+void GapBuffer::assign(std::string_view text) {
+  storage_.assign(text.begin(), text.end());
+  gap_begin_ = storage_.size();
+  gap_end_ = storage_.size();
+  cursor_ = storage_.size();
+}
+
+void GapBuffer::clear() noexcept {
+  storage_.clear();
+  gap_begin_ = 0;
+  gap_end_ = 0;
+  cursor_ = 0;
+}
+
+void GapBuffer::insert(std::string_view text) {
+  if (text.empty()) {
+    return;
+  }
+  move_gap(cursor_);
+  reserve_gap(text.size());
+  std::ranges::copy(text, storage_.begin() + static_cast<std::ptrdiff_t>(gap_begin_));
+  gap_begin_ += text.size();
+  cursor_ = gap_begin_;
+}
+
+bool GapBuffer::erase_before() {
+  if (cursor_ == 0U) {
+    return false;
+  }
+  move_gap(cursor_);
+  gap_begin_ = previous_codepoint_start(before_gap(), gap_begin_);
+  cursor_ = gap_begin_;
+  return true;
+}
+
+bool GapBuffer::erase_after() {
+  if (cursor_at_end()) {
+    return false;
+  }
+  move_gap(cursor_);
+  gap_end_ += next_boundary() - cursor_;
+  return true;
+}
+
+bool GapBuffer::move_left() {
+  if (cursor_ == 0U) {
+    return false;
+  }
+  move_gap(cursor_);
+  const std::string_view before = before_gap();
+  do {
+    cursor_ = previous_codepoint_start(before, cursor_);
+  } while (cursor_ > 0U && codepoint_width(decode_utf8(before, cursor_).codepoint) == 0U);
+  return true;
+}
+
+bool GapBuffer::move_right() {
+  if (cursor_at_end()) {
+    return false;
+  }
+  move_gap(cursor_);
+  cursor_ = next_boundary();
+  return true;
+}
+
+void GapBuffer::move_home() noexcept {
+  cursor_ = 0;
+}
+
+void GapBuffer::move_end() noexcept {
+  cursor_ = size();
+}
+
+std::size_t GapBuffer::cursor() const noexcept {
+  return cursor_;
+}
+
+bool GapBuffer::cursor_at_end() const noexcept {
+  return cursor_ == size();
+}
+
+std::size_t GapBuffer::size() const noexcept {
+  return storage_.size() - gap_size();
+}
+
+bool GapBuffer::empty() const noexcept {
+  return size() == 0U;
+}
+
+std::string_view GapBuffer::text() {
+  move_gap(size());
+  return before_gap();
+}
+
+std::size_t GapBuffer::gap_size() const noexcept {
+  return gap_end_ - gap_begin_;
+}
+
+std::string_view GapBuffer::before_gap() const noexcept {
+  return std::string_view{storage_.data(), gap_begin_};
+}
+
+std::string_view GapBuffer::after_gap() const noexcept {
+  return std::string_view{storage_.data() + gap_end_, storage_.size() - gap_end_};
+}
+
+// End of the character starting at the cursor, which must sit at the gap.
+std::size_t GapBuffer::next_boundary() const noexcept {
+  const std::string_view after = after_gap();
+  std::size_t offset = decode_utf8(after, 0).length;
+  while (offset < after.size()) {
+    const DecodedCodepoint next = decode_utf8(after, offset);
+    if (codepoint_width(next.codepoint) != 0U) {
+      break;
+    }
+    offset += next.length;
+  }
+  return cursor_ + offset;
+}
+
+void GapBuffer::move_gap(const std::size_t position) {
+  if (gap_size() == 0U) {
+    gap_begin_ = position;
+    gap_end_ = position;
+    return;
+  }
+
+  const auto data = storage_.begin();
+  if (position < gap_begin_) {
+    const auto moved = static_cast<std::ptrdiff_t>(gap_begin_ - position);
+    std::copy_backward(data + static_cast<std::ptrdiff_t>(position),
+                       data + static_cast<std::ptrdiff_t>(gap_begin_),
+                       data + static_cast<std::ptrdiff_t>(gap_end_));
+    gap_begin_ -= static_cast<std::size_t>(moved);
+    gap_end_ -= static_cast<std::size_t>(moved);
+  } else if (position > gap_begin_) {
+    const auto moved = static_cast<std::ptrdiff_t>(position - gap_begin_);
+    std::copy(data + static_cast<std::ptrdiff_t>(gap_end_),
+              data + static_cast<std::ptrdiff_t>(gap_end_) + moved,
+              data + static_cast<std::ptrdiff_t>(gap_begin_));
+    gap_begin_ += static_cast<std::size_t>(moved);
+    gap_end_ += static_cast<std::size_t>(moved);
+  }
+}
+
+void GapBuffer::reserve_gap(const std::size_t bytes) {
+  if (gap_size() >= bytes) {
+    return;
+  }
+
+  // Doubling keeps a run of inserts amortized O(1) per byte.
+  const std::size_t capacity = std::max({storage_.size() * 2U, size() + bytes + kMinimumGap});
+  std::vector<char> grown(capacity);
+  std::ranges::copy(before_gap(), grown.begin());
+  const std::string_view after = after_gap();
+  std::ranges::copy(after, grown.end() - static_cast<std::ptrdiff_t>(after.size()));
+
+  gap_end_ = capacity - after.size();
+  storage_ = std::move(grown);
+}
+
+} // namespace opentui
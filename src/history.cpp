@@ -0,0 +1,342 @@
+#include "opentui/history.hpp"
+
+#include <algorithm>
+#include <cerrno>
+
+#if defined(_WIN32)
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace opentui {
+namespace {
+
+// Compaction only pays off once a meaningful amount of the arena belongs to evicted entries.
+constexpr std::size_t kMinimumCompactionBytes = 4096;
+
+void append_escaped(std::string& output, std::string_view line) {
+  for (const char character : line) {
+    if (character == '\\') {
+      output += "\\\\";
+    } else if (character == '\n') {
+      output += "\\n";
+    } else if (character == '\r') {
+      output += "\\r";
+    } else {
+      output.push_back(character);
+    }
+  }
+}
+
+[[nodiscard]] std::string unescape(std::string_view record) {
+  std::string line;
+  line.reserve(record.size());
+  for (std::size_t index = 0; index < record.size(); ++index) {
+    const char character = record[index];
+    if (character != '\\' || index + 1U == record.size()) {
+      line.push_back(character);
+      continue;
+    }
+
+    const char escaped = record[++index];
+    if (escaped == 'n') {
+      line.push_back('\n');
+    } else if (escaped == 'r') {
+      line.push_back('\r');
+    } else {
+      line.push_back(escaped);
+    }
+  }
+  return line;
+}
+
+#if !defined(_WIN32)
+void lock_file(const int file_descriptor, const int operation) {
+  while (flock(file_descriptor, operation) != 0 && errno == EINTR) {
+  }
+}
+
+void write_all(const int file_descriptor, std::string_view bytes) {
+  while (!bytes.empty()) {
+    const ssize_t written = ::write(file_descriptor, bytes.data(), bytes.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return;
+    }
+    bytes.remove_prefix(static_cast<std::size_t>(written));
+  }
+}
+
+[[nodiscard]] std::uint64_t file_size(const int file_descriptor) {
+  struct stat info {};
+  if (fstat(file_descriptor, &info) != 0 || info.st_size < 0) {
+    return 0U;
+  }
+  return static_cast<std::uint64_t>(info.st_size);
+}
+#endif
+
+} // namespace
+
+History::History(const std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1U)), slots_(capacity_) {}
+
+History::~History() {
+  close_file();
+}
+
+bool History::open_file(const std::filesystem::path& path) {
+  close_file();
+
+#if defined(_WIN32)
+  {
+    std::ofstream create(path, std::ios::app | std::ios::binary);
+  }
+  std::ifstream input(path, std::ios::binary);
+  if (!input) {
+    return false;
+  }
+  const std::string contents{std::istreambuf_iterator<char>(input),
+                             std::istreambuf_iterator<char>()};
+  synced_bytes_ = load_records(contents);
+  path_ = path;
+  return true;
+#else
+  const int file_descriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+  if (file_descriptor < 0) {
+    return false;
+  }
+
+  lock_file(file_descriptor, LOCK_SH);
+  const std::uint64_t size = file_size(file_descriptor);
+  bool loaded = true;
+  std::uint64_t consumed = 0;
+  if (size != 0U) {
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+      loaded = false;
+    } else {
+      consumed = load_records(std::string_view{static_cast<const char*>(mapping), size});
+      munmap(mapping, size);
+    }
+  }
+  lock_file(file_descriptor, LOCK_UN);
+
+  if (!loaded) {
+    ::close(file_descriptor);
+    return false;
+  }
+
+  file_descriptor_ = file_descriptor;
+  synced_bytes_ = consumed;
+  path_ = path;
+  return true;
+#endif
+}
+
+void History::close_file() noexcept {
+#if !defined(_WIN32)
+  if (file_descriptor_ >= 0) {
+    ::close(file_descriptor_);
+  }
+#endif
+  file_descriptor_ = -1;
+  synced_bytes_ = 0;
+  path_.clear();
+}
+
+bool History::has_file() const noexcept {
+  return !path_.empty();
+}
+
+void History::add(std::string_view line) {
+  if (line.empty() || (!empty() && back() == line)) {
+    return;
+  }
+
+  std::string record;
+  append_escaped(record, line);
+  record.push_back('\n');
+
+#if defined(_WIN32)
+  if (!path_.empty()) {
+    std::ofstream output(path_, std::ios::app | std::ios::binary);
+    output << record;
+  }
+#else
+  if (file_descriptor_ >= 0) {
+    lock_file(file_descriptor_, LOCK_EX);
+    // A record torn by a crashed writer must not swallow ours.
+    if (merge_appended_records() > synced_bytes_) {
+      record.insert(record.begin(), '\n');
+    }
+    write_all(file_descriptor_, record);
+    synced_bytes_ = file_size(file_descriptor_);
+    lock_file(file_descriptor_, LOCK_UN);
+  }
+#endif
+
+  if (!empty() && back() == line) {
+    return;
+  }
+  store(line);
+}
+
+std::size_t History::size() const noexcept {
+  return size_;
+}
+
+bool History::empty() const noexcept {
+  return size_ == 0U;
+}
+
+std::size_t History::capacity() const noexcept {
+  return capacity_;
+}
+
+std::string_view History::operator[](const std::size_t index) const {
+  const Slot& slot = slots_[(head_ + index) % capacity_];
+  return std::string_view{arena_.data() + slot.offset, slot.length};
+}
+
+std::string_view History::back() const {
+  return (*this)[size_ - 1U];
+}
+
+std::optional<std::size_t> History::newest_extending(std::string_view prefix) const {
+  const std::optional<std::uint64_t> sequence = index_.newest_extending(prefix);
+  if (!sequence.has_value()) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(*sequence - (next_sequence_ - size_));
+}
+
+std::optional<std::size_t> History::search_backward(std::string_view pattern,
+                                                    std::size_t before) const {
+  before = std::min(before, size_);
+  if (pattern.size() < HistoryIndex::kTrigramLength) {
+    // Too short to be indexed, but short patterns match often, so the scan ends early.
+    for (std::size_t index = before; index-- > 0U;) {
+      if ((*this)[index].find(pattern) != std::string_view::npos) {
+        return index;
+      }
+    }
+    return std::nullopt;
+  }
+
+  const std::uint64_t oldest = next_sequence_ - size_;
+  const std::optional<std::uint64_t> sequence = index_.newest_containing(
+      pattern, oldest + before, [this, oldest](const std::uint64_t candidate) {
+        return (*this)[static_cast<std::size_t>(candidate - oldest)];
+      });
+  if (!sequence.has_value()) {
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(*sequence - oldest);
+}
+
+void History::store(std::string_view line) {
+  if (size_ == capacity_) {
+    index_.evict(next_sequence_ - size_, (*this)[0]);
+    live_bytes_ -= slots_[head_].length;
+    head_ = (head_ + 1U) % capacity_;
+    --size_;
+  }
+
+  const std::size_t dead_bytes = arena_.size() - live_bytes_;
+  if (dead_bytes >= kMinimumCompactionBytes && dead_bytes > live_bytes_) {
+    compact();
+  }
+
+  slots_[(head_ + size_) % capacity_] = Slot{.offset = arena_.size(), .length = line.size()};
+  arena_.insert(arena_.end(), line.begin(), line.end());
+  live_bytes_ += line.size();
+  ++size_;
+  index_.insert(next_sequence_++, line);
+}
+
+void History::compact() {
+  std::vector<char> compacted;
+  compacted.reserve(live_bytes_ * 2U);
+  for (std::size_t index = 0; index < size_; ++index) {
+    Slot& slot = slots_[(head_ + index) % capacity_];
+    const std::size_t offset = compacted.size();
+    compacted.insert(compacted.end(), arena_.begin() + static_cast<std::ptrdiff_t>(slot.offset),
+                     arena_.begin() + static_cast<std::ptrdiff_t>(slot.offset + slot.length));
+    slot.offset = offset;
+  }
+  arena_ = std::move(compacted);
+}
+
+std::size_t History::load_records(std::string_view text) {
+  const std::size_t complete = text.rfind('\n');
+  if (complete == std::string_view::npos) {
+    return 0U;
+  }
+
+  // Walk backwards from the newest record until the ring would be full.
+  std::vector<std::string_view> newest_first;
+  std::size_t end = complete;
+  while (newest_first.size() < capacity_) {
+    const std::size_t separator = end == 0U ? std::string_view::npos : text.rfind('\n', end - 1U);
+    const std::size_t start = separator == std::string_view::npos ? 0U : separator + 1U;
+    if (end > start) {
+      newest_first.push_back(text.substr(start, end - start));
+    }
+    if (separator == std::string_view::npos) {
+      break;
+    }
+    end = separator;
+  }
+
+  for (auto record = newest_first.rbegin(); record != newest_first.rend(); ++record) {
+    const std::string line = unescape(*record);
+    if (empty() || back() != line) {
+      store(line);
+    }
+  }
+  return complete + 1U;
+}
+
+#if !defined(_WIN32)
+std::uint64_t History::merge_appended_records() {
+  const std::uint64_t size = file_size(file_descriptor_);
+  if (size < synced_bytes_) {
+    // Truncated by someone else; start over from its new end.
+    synced_bytes_ = size;
+    return size;
+  }
+  if (size == synced_bytes_) {
+    return size;
+  }
+
+  std::string appended(size - synced_bytes_, '\0');
+  std::size_t filled = 0;
+  while (filled < appended.size()) {
+    const ssize_t count =
+        pread(file_descriptor_, appended.data() + filled, appended.size() - filled,
+              static_cast<off_t>(synced_bytes_ + filled));
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      break;
+    }
+    filled += static_cast<std::size_t>(count);
+  }
+  appended.resize(filled);
+
+  synced_bytes_ += load_records(appended);
+  return size;
+}
+#endif
+
+} // namespace opentui
@@ -0,0 +1,286 @@
+#include "opentui/history_index.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <span>
+
+namespace opentui {
+namespace {
+
+// Posting lists drop their evicted front lazily and compact once it dominates.
+constexpr std::size_t kMinimumPostingsCompaction = 64;
+
+[[nodiscard]] std::uint32_t trigram_key(std::string_view text, const std::size_t offset) {
+  return (static_cast<std::uint32_t>(static_cast<unsigned char>(text[offset])) << 16U) |
+         (static_cast<std::uint32_t>(static_cast<unsigned char>(text[offset + 1U])) << 8U) |
+         static_cast<std::uint32_t>(static_cast<unsigned char>(text[offset + 2U]));
+}
+
+[[nodiscard]] std::size_t shared_length(std::string_view left, std::string_view right) {
+  const auto mismatch = std::ranges::mismatch(left, right);
+  return static_cast<std::size_t>(mismatch.in1 - left.begin());
+}
+
+} // namespace
+
+HistoryIndex::HistoryIndex() {
+  clear();
+}
+
+void HistoryIndex::clear() {
+  nodes_.assign(1U, Node{});
+  free_nodes_.clear();
+  trigrams_.clear();
+}
+
+std::uint32_t HistoryIndex::find_child(const std::uint32_t node, const char first) const {
+  for (const std::uint32_t child : nodes_[node].children) {
+    if (nodes_[child].label.front() == first) {
+      return child;
+    }
+  }
+  return kNoNode;
+}
+
+std::uint32_t HistoryIndex::allocate_node(std::string_view label, const std::uint64_t sequence) {
+  std::uint32_t node = kNoNode;
+  if (free_nodes_.empty()) {
+    node = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  } else {
+    node = free_nodes_.back();
+    free_nodes_.pop_back();
+  }
+
+  Node& created = nodes_[node];
+  created.label.assign(label);
+  created.newest = sequence;
+  created.newest_longer = 0;
+  created.children.clear();
+  return node;
+}
+
+void HistoryIndex::release_subtree(const std::uint32_t node) {
+  std::vector<std::uint32_t> pending{node};
+  while (!pending.empty()) {
+    const std::uint32_t current = pending.back();
+    pending.pop_back();
+    pending.insert(pending.end(), nodes_[current].children.begin(),
+                   nodes_[current].children.end());
+    nodes_[current].children.clear();
+    nodes_[current].label.clear();
+    free_nodes_.push_back(current);
+  }
+}
+
+void HistoryIndex::insert(const std::uint64_t sequence, std::string_view entry) {
+  std::uint32_t node = 0;
+  std::string_view rest = entry;
+  while (true) {
+    nodes_[node].newest = sequence;
+    if (rest.empty()) {
+      break;
+    }
+    nodes_[node].newest_longer = sequence;
+
+    std::uint32_t child = find_child(node, rest.front());
+    if (child == kNoNode) {
+      child = allocate_node(rest, sequence);
+      nodes_[node].children.push_back(child);
+      break;
+    }
+
+    const std::size_t shared = shared_length(nodes_[child].label, rest);
+    if (shared < nodes_[child].label.size()) {
+      // Split the edge so the new entry diverges, or ends, at a node boundary. The label is
+      // copied first because allocating may reallocate the node it lives in.
+      const std::string head = nodes_[child].label.substr(0, shared);
+      const std::uint32_t middle = allocate_node(head, sequence);
+      nodes_[middle].newest = nodes_[child].newest;
+      nodes_[middle].newest_longer = nodes_[child].newest;
+      nodes_[middle].children.push_back(child);
+      nodes_[child].label.erase(0, shared);
+      std::ranges::replace(nodes_[node].children, child, middle);
+      child = middle;
+    }
+
+    rest.remove_prefix(shared);
+    node = child;
+  }
+
+  for (std::size_t offset = 0; offset + kTrigramLength <= entry.size(); ++offset) {
+    Postings& postings = trigrams_[trigram_key(entry, offset)];
+    if (postings.sequences.empty() || postings.sequences.back() != sequence) {
+      postings.sequences.push_back(sequence);
+    }
+  }
+}
+
+void HistoryIndex::evict(const std::uint64_t sequence, std::string_view entry) {
+  // Everything older than `sequence` is already gone, so a node whose newest entry is the evicted
+  // one has nothing else left below it.
+  std::uint32_t parent = kNoNode;
+  std::uint32_t node = 0;
+  std::string_view rest = entry;
+  while (true) {
+    if (nodes_[node].newest == sequence) {
+      if (parent == kNoNode) {
+        clear();
+        return;
+      }
+      std::erase(nodes_[parent].children, node);
+      release_subtree(node);
+      break;
+    }
+    if (rest.empty()) {
+      break;
+    }
+    if (nodes_[node].newest_longer == sequence) {
+      nodes_[node].newest_longer = 0;
+    }
+
+    const std::uint32_t child = find_child(node, rest.front());
+    if (child == kNoNode) {
+      break;
+    }
+    rest.remove_prefix(std::min(rest.size(), nodes_[child].label.size()));
+    parent = node;
+    node = child;
+  }
+
+  for (std::size_t offset = 0; offset + kTrigramLength <= entry.size(); ++offset) {
+    const auto iterator = trigrams_.find(trigram_key(entry, offset));
+    if (iterator == trigrams_.end()) {
+      continue;
+    }
+
+    Postings& postings = iterator->second;
+    if (postings.start < postings.sequences.size() &&
+        postings.sequences[postings.start] == sequence) {
+      ++postings.start;
+    }
+    if (postings.start == postings.sequences.size()) {
+      trigrams_.erase(iterator);
+    } else if (postings.start >= kMinimumPostingsCompaction &&
+               postings.start * 2U >= postings.sequences.size()) {
+      postings.sequences.erase(postings.sequences.begin(),
+                               postings.sequences.begin() +
+                                   static_cast<std::ptrdiff_t>(postings.start));
+      postings.start = 0;
+    }
+  }
+}
+
+std::optional<std::uint64_t> HistoryIndex::newest_extending(std::string_view prefix) const {
+  std::uint32_t node = 0;
+  std::string_view rest = prefix;
+  while (!rest.empty()) {
+    const std::uint32_t child = find_child(node, rest.front());
+    if (child == kNoNode) {
+      return std::nullopt;
+    }
+
+    const std::string_view label = nodes_[child].label;
+    const std::size_t shared = shared_length(label, rest);
+    if (shared == rest.size() && shared < label.size()) {
+      // The prefix ends inside this edge, so every entry below it is longer.
+      return nodes_[child].newest;
+    }
+    if (shared < label.size()) {
+      return std::nullopt;
+    }
+
+    rest.remove_prefix(shared);
+    node = child;
+  }
+
+  if (nodes_[node].newest_longer == 0U) {
+    return std::nullopt;
+  }
+  return nodes_[node].newest_longer;
+}
+
+std::optional<std::uint64_t> HistoryIndex::newest_containing(std::string_view pattern,
+                                                             const std::uint64_t before,
+                                                             const EntryLookup& entry) const {
+  if (pattern.size() < kTrigramLength || before == 0U) {
+    return std::nullopt;
+  }
+
+  // Only entries holding every trigram of the pattern need to be checked, so the posting lists
+  // are intersected newest first. Lists are asked rarest first to move back to their newest
+  // sequence at or below the current candidate, galloping so that a list skips a long run in
+  // O(log run) steps; a candidate every list agrees on is checked against the entry itself.
+  struct Cursor {
+    std::span<const std::uint64_t> sequences;
+    // Sequences at or past `end` are newer than every remaining candidate.
+    std::size_t end;
+  };
+  std::vector<Cursor> cursors;
+  for (std::size_t offset = 0; offset + kTrigramLength <= pattern.size(); ++offset) {
+    const auto iterator = trigrams_.find(trigram_key(pattern, offset));
+    if (iterator == trigrams_.end()) {
+      return std::nullopt;
+    }
+
+    const Postings& postings = iterator->second;
+    const std::span<const std::uint64_t> live =
+        std::span{postings.sequences}.subspan(postings.start);
+    // A trigram repeated in the pattern adds its list once.
+    if (std::ranges::none_of(cursors, [&live](const Cursor& cursor) {
+          return cursor.sequences.data() == live.data();
+        })) {
+      cursors.push_back(Cursor{.sequences = live, .end = live.size()});
+    }
+  }
+  std::ranges::sort(cursors, [](const Cursor& left, const Cursor& right) {
+    return left.sequences.size() < right.sequences.size();
+  });
+
+  const auto seek = [](Cursor& cursor, const std::uint64_t target) {
+    const std::span<const std::uint64_t> sequences = cursor.sequences;
+    if (cursor.end == 0U || sequences[cursor.end - 1U] <= target) {
+      return cursor.end != 0U;
+    }
+    // sequences[newer] > target throughout; widen the step until one lands at or below it.
+    std::size_t newer = cursor.end - 1U;
+    std::size_t step = 1;
+    while (step <= newer && sequences[newer - step] > target) {
+      newer -= step;
+      step *= 2U;
+    }
+    const std::size_t older = step <= newer ? newer - step : 0U;
+    cursor.end = static_cast<std::size_t>(
+        std::upper_bound(sequences.begin() + static_cast<std::ptrdiff_t>(older),
+                         sequences.begin() + static_cast<std::ptrdiff_t>(newer), target) -
+        sequences.begin());
+    return cursor.end != 0U;
+  };
+
+  std::uint64_t candidate = before - 1U;
+  std::size_t next = 0;
+  while (true) {
+    if (next == cursors.size()) {
+      if (entry(candidate).find(pattern) != std::string_view::npos) {
+        return candidate;
+      }
+      if (candidate == 0U) {
+        return std::nullopt;
+      }
+      --candidate;
+      next = 0;
+    }
+
+    Cursor& cursor = cursors[next];
+    if (!seek(cursor, candidate)) {
+      return std::nullopt;
+    }
+    const std::uint64_t newest = cursor.sequences[cursor.end - 1U];
+    // The rarest list sets the candidate; when a later one moves it back, the rarer lists are
+    // asked about the older candidate again before the more common ones.
+    next = newest == candidate || next == 0U ? next + 1U : 0U;
+    candidate = newest;
+  }
+}
+
+} // namespace opentui
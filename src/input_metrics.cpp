@@ -0,0 +1,153 @@
+#include "opentui/input_metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <fstream>
+
+#include "opentui/display_width.hpp"
+
+namespace opentui {
+namespace {
+
+constexpr std::array<std::string_view, kInputStageCount> kStageNames = {
+    "decode", "completion", "autosuggestion", "frame build", "write", "key to paint",
+};
+
+constexpr std::size_t kStageColumnWidth = 16;
+constexpr std::size_t kValueColumnWidth = 10;
+
+[[nodiscard]] std::string format_duration(const std::uint64_t nanoseconds) {
+  std::array<char, 32> text{};
+  if (nanoseconds < 1'000U) {
+    std::snprintf(text.data(), text.size(), "%lluns", static_cast<unsigned long long>(nanoseconds));
+  } else if (nanoseconds < 1'000'000U) {
+    std::snprintf(text.data(), text.size(), "%.1fus", static_cast<double>(nanoseconds) / 1e3);
+  } else {
+    std::snprintf(text.data(), text.size(), "%.2fms", static_cast<double>(nanoseconds) / 1e6);
+  }
+  return text.data();
+}
+
+} // namespace
+
+std::string_view input_stage_name(const InputStage stage) noexcept {
+  return kStageNames[static_cast<std::size_t>(stage)];
+}
+
+std::uint64_t LatencyHistogram::bucket_upper_bound(const std::size_t bucket) noexcept {
+  return bucket == 0U ? 0U : (std::uint64_t{1} << bucket) - 1U;
+}
+
+void LatencyHistogram::record(const std::uint64_t nanoseconds) noexcept {
+  // With a single recording thread, plain relaxed loads and stores suffice and avoid the locked
+  // read-modify-write instructions.
+  const auto bucket = std::min<std::size_t>(std::bit_width(nanoseconds), kBuckets - 1U);
+  buckets_[bucket].store(buckets_[bucket].load(std::memory_order_relaxed) + 1U,
+                         std::memory_order_relaxed);
+  total_nanoseconds_.store(total_nanoseconds_.load(std::memory_order_relaxed) + nanoseconds,
+                           std::memory_order_relaxed);
+  if (nanoseconds > max_nanoseconds_.load(std::memory_order_relaxed)) {
+    max_nanoseconds_.store(nanoseconds, std::memory_order_relaxed);
+  }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const noexcept {
+  Snapshot snapshot;
+  for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+    snapshot.buckets[bucket] = buckets_[bucket].load(std::memory_order_relaxed);
+    snapshot.count += snapshot.buckets[bucket];
+  }
+  snapshot.total_nanoseconds = total_nanoseconds_.load(std::memory_order_relaxed);
+  snapshot.max_nanoseconds = max_nanoseconds_.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+void LatencyHistogram::reset() noexcept {
+  for (std::atomic<std::uint64_t>& bucket : buckets_) {
+    bucket.store(0U, std::memory_order_relaxed);
+  }
+  total_nanoseconds_.store(0U, std::memory_order_relaxed);
+  max_nanoseconds_.store(0U, std::memory_order_relaxed);
+}
+
+std::uint64_t
+LatencyHistogram::Snapshot::percentile_nanoseconds(const double fraction) const noexcept {
+  if (count == 0U) {
+    return 0U;
+  }
+  const auto wanted = std::max<std::uint64_t>(
+      1U, static_cast<std::uint64_t>(fraction * static_cast<double>(count) + 0.5));
+  std::uint64_t seen = 0;
+  for (std::size_t bucket = 0; bucket < kBuckets; ++bucket) {
+    seen += buckets[bucket];
+    if (seen >= wanted) {
+      // The top bucket is open-ended; the maximum bounds it more tightly.
+      return std::min(bucket_upper_bound(bucket), max_nanoseconds);
+    }
+  }
+  return max_nanoseconds;
+}
+
+std::uint64_t LatencyHistogram::Snapshot::mean_nanoseconds() const noexcept {
+  return count == 0U ? 0U : total_nanoseconds / count;
+}
+
+void InputMetrics::record(const InputStage stage, const Clock::duration elapsed) noexcept {
+  const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  histograms_[static_cast<std::size_t>(stage)].record(
+      nanoseconds < 0 ? 0U : static_cast<std::uint64_t>(nanoseconds));
+}
+
+const LatencyHistogram& InputMetrics::histogram(const InputStage stage) const noexcept {
+  return histograms_[static_cast<std::size_t>(stage)];
+}
+
+void InputMetrics::reset() noexcept {
+  for (LatencyHistogram& histogram : histograms_) {
+    histogram.reset();
+  }
+}
+
+std::string InputMetrics::report() const {
+  std::string report = pad_to_width("stage", kStageColumnWidth);
+  for (const std::string_view column : {"count", "mean", "p50", "p90", "p99"}) {
+    report += pad_to_width(column, kValueColumnWidth);
+  }
+  report += "max";
+
+  for (std::size_t stage = 0; stage < kInputStageCount; ++stage) {
+    const LatencyHistogram::Snapshot snapshot = histograms_[stage].snapshot();
+    report += '\n';
+    report += pad_to_width(kStageNames[stage], kStageColumnWidth);
+    report += pad_to_width(std::to_string(snapshot.count), kValueColumnWidth);
+    report += pad_to_width(format_duration(snapshot.mean_nanoseconds()), kValueColumnWidth);
+    for (const double fraction : {0.5, 0.9, 0.99}) {
+      report += pad_to_width(format_duration(snapshot.percentile_nanoseconds(fraction)),
+                             kValueColumnWidth);
+    }
+    report += format_duration(snapshot.max_nanoseconds);
+  }
+  return report;
+}
+
+bool InputMetrics::export_csv(const std::filesystem::path& path) const {
+  std::ofstream output(path, std::ios::trunc);
+  if (!output) {
+    return false;
+  }
+
+  output << "stage,bucket_upper_ns,count\n";
+  for (std::size_t stage = 0; stage < kInputStageCount; ++stage) {
+    const LatencyHistogram::Snapshot snapshot = histograms_[stage].snapshot();
+    for (std::size_t bucket = 0; bucket < LatencyHistogram::kBuckets; ++bucket) {
+      if (snapshot.buckets[bucket] != 0U) {
+        output << kStageNames[stage] << ',' << LatencyHistogram::bucket_upper_bound(bucket) << ','
+               << snapshot.buckets[bucket] << '\n';
+      }
+    }
+  }
+  return static_cast<bool>(output.flush());
+}
+
+} // namespace opentui
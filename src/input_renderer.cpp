@@ -0,0 +1,417 @@
+#include "opentui/input_renderer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "opentui/ansi.hpp"
+#include "opentui/console.hpp"
+#include "opentui/display_width.hpp"
+
+namespace opentui {
+namespace {
+
+// The input line of a frame, held as `head` followed by `tail`.
+struct LineText {
+  std::string_view head{};
+  std::string_view tail{};
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return head.size() + tail.size();
+  }
+
+  [[nodiscard]] char operator[](const std::size_t index) const noexcept {
+    return index < head.size() ? head[index] : tail[index - head.size()];
+  }
+
+  // The first `length` bytes, and the bytes from `offset` on.
+  [[nodiscard]] LineText first(const std::size_t length) const noexcept {
+    if (length <= head.size()) {
+      return LineText{.head = head.substr(0, length)};
+    }
+    return LineText{.head = head, .tail = tail.substr(0, length - head.size())};
+  }
+
+  [[nodiscard]] LineText from(const std::size_t offset) const noexcept {
+    if (offset >= head.size()) {
+      return LineText{.head = tail.substr(offset - head.size())};
+    }
+    return LineText{.head = head.substr(offset), .tail = tail};
+  }
+
+  [[nodiscard]] std::size_t width() const noexcept {
+    return display_width(head) + display_width(tail);
+  }
+
+  // Length of the longest prefix that fits in `columns`; costs O(columns), not O(size()).
+  [[nodiscard]] std::size_t bytes_within(const std::size_t columns) const noexcept {
+    const std::size_t in_head = prefix_bytes_for_width(head, columns);
+    if (in_head < head.size()) {
+      return in_head;
+    }
+    // The whole head fits, so it is short enough to measure.
+    return in_head + prefix_bytes_for_width(tail, columns - display_width(head));
+  }
+
+  [[nodiscard]] DecodedCodepoint decode(const std::size_t index) const noexcept {
+    return index < head.size() ? decode_utf8(head, index) : decode_utf8(tail, index - head.size());
+  }
+
+  void append_to(std::string& output) const {
+    output.append(head);
+    output.append(tail);
+  }
+};
+
+[[nodiscard]] LineText line_of(const InputFrame& frame) {
+  return LineText{.head = frame.buffer, .tail = frame.buffer_tail};
+}
+
+[[nodiscard]] bool is_continuation_byte(const char byte) noexcept {
+  return (static_cast<unsigned char>(byte) & 0xC0U) == 0x80U;
+}
+
+// Earliest offset, no earlier than `floor`, from which the line up to `end` fits in `columns`.
+// Never starts on a combining mark, which would be drawn without its base character.
+[[nodiscard]] std::size_t walk_back(const LineText& line, const std::size_t end,
+                                    const std::size_t columns, const std::size_t floor) {
+  std::size_t offset = end;
+  std::size_t used = 0;
+  while (offset > floor) {
+    std::size_t previous = offset - 1U;
+    while (previous > floor && is_continuation_byte(line[previous])) {
+      --previous;
+    }
+    const std::size_t width = codepoint_width(line.decode(previous).codepoint);
+    if (used + width > columns) {
+      break;
+    }
+    used += width;
+    offset = previous;
+  }
+  while (offset < end && codepoint_width(line.decode(offset).codepoint) == 0U) {
+    offset += line.decode(offset).length;
+  }
+  return offset;
+}
+
+// Where the part of the line shown in `room` columns starts. It stays at `previous` while the
+// cursor is in view there, and otherwise moves to put the cursor in the middle of the row.
+[[nodiscard]] std::size_t visible_start(const LineText& line, const std::size_t cursor,
+                                        const std::size_t room, const std::size_t previous) {
+  if (line.bytes_within(room) == line.size()) {
+    return 0;
+  }
+  if (previous <= cursor) {
+    std::size_t start = previous;
+    while (start > 0U && is_continuation_byte(line[start])) {
+      --start;
+    }
+    if (walk_back(line, cursor, room, start) == start) {
+      return start;
+    }
+  }
+  return walk_back(line, cursor, room / 2U, 0);
+}
+
+[[nodiscard]] bool starts_with(std::string_view text, const LineText& prefix) {
+  return text.starts_with(prefix.head) && text.substr(prefix.head.size()).starts_with(prefix.tail);
+}
+
+[[nodiscard]] std::string_view ghost_suffix(std::string_view autosuggestion, const LineText& line) {
+  if (autosuggestion.size() <= line.size() || !starts_with(autosuggestion, line)) {
+    return {};
+  }
+  return autosuggestion.substr(line.size());
+}
+
+// Compares a block at a time first, since a pasted line can run to hundreds of kilobytes.
+[[nodiscard]] std::size_t shared_length(std::string_view left, std::string_view right) {
+  constexpr std::size_t kBlock = 64;
+  const std::size_t limit = std::min(left.size(), right.size());
+  std::size_t length = 0;
+  while (length + kBlock <= limit &&
+         std::memcmp(left.data() + length, right.data() + length, kBlock) == 0) {
+    length += kBlock;
+  }
+  while (length < limit && left[length] == right[length]) {
+    ++length;
+  }
+  return length;
+}
+
+// Length of the shared prefix, backed off to a UTF-8 sequence boundary.
+[[nodiscard]] std::size_t common_prefix_length(std::string_view left, const LineText& right) {
+  std::size_t length = shared_length(left, right.head);
+  if (length == right.head.size()) {
+    length += shared_length(left.substr(length), right.tail);
+  }
+  while (length > 0U && length < right.size() &&
+         (static_cast<unsigned char>(right[length]) & 0xC0U) == 0x80U) {
+    --length;
+  }
+  return length;
+}
+
+[[nodiscard]] std::size_t common_prefix_length(std::string_view left, std::string_view right) {
+  return common_prefix_length(left, LineText{.head = right});
+}
+
+void append_ghost(std::string& output, std::string_view ghost) {
+  if (ghost.empty()) {
+    return;
+  }
+  const Style ghost_style{Color::BrightBlack};
+  output.append(ghost_style.prefix());
+  output.append(ghost);
+  output.append(Style::reset());
+}
+
+} // namespace
+
+InputRenderer::InputRenderer(Console& console)
+    : console_(console), synchronized_output_(ansi::terminal_supports_synchronized_output()) {}
+
+void InputRenderer::set_columns(const std::size_t columns) noexcept {
+  if (columns != columns_) {
+    columns_ = columns;
+    shown_valid_ = false;
+  }
+}
+
+std::size_t InputRenderer::columns() const noexcept {
+  return columns_;
+}
+
+void InputRenderer::set_synchronized_output(const bool enabled) noexcept {
+  synchronized_output_ = enabled;
+}
+
+bool InputRenderer::synchronized_output() const noexcept {
+  return synchronized_output_;
+}
+
+void InputRenderer::set_metrics(InputMetrics* metrics) noexcept {
+  metrics_ = metrics;
+}
+
+void InputRenderer::render(const InputFrame& frame) {
+  StageTimer build_timer(metrics_, InputStage::FrameBuild);
+  begin_frame();
+  build(frame);
+  build_timer.stop();
+
+  const StageTimer write_timer(metrics_, InputStage::Write);
+  end_frame();
+}
+
+void InputRenderer::commit(std::string_view prompt, std::string_view buffer) {
+  begin_frame();
+  if (columns_ != 0U && display_width(prompt) + display_width(buffer) >= columns_) {
+    // The whole line is left behind, wrapping over the rows below, so those are cleared first.
+    frame_.push_back('\r');
+    frame_.append(ansi::kClearToScreenEnd);
+    frame_.append(prompt);
+    frame_.append(buffer);
+    frame_.push_back('\n');
+    invalidate();
+    end_frame();
+    return;
+  }
+  build(InputFrame{.prompt = prompt, .buffer = buffer, .completion_rows = shown_completion_rows_});
+  // The cursor lands on the first completion row, so clearing them from there saves a round trip.
+  frame_.push_back('\n');
+  if (!shown_completion_rows_.empty()) {
+    frame_.append(ansi::kClearToScreenEnd);
+  }
+  invalidate();
+  end_frame();
+}
+
+void InputRenderer::clear() {
+  console_.emit("\r");
+  console_.emit(ansi::kClearToScreenEnd);
+  invalidate();
+}
+
+void InputRenderer::invalidate() noexcept {
+  shown_valid_ = false;
+  shown_start_ = 0;
+  shown_completion_rows_.clear();
+}
+
+std::size_t InputRenderer::last_frame_bytes() const noexcept {
+  return frame_.size();
+}
+
+void InputRenderer::begin_frame() {
+  frame_.clear();
+  if (synchronized_output_) {
+    frame_.append(ansi::kBeginSynchronizedUpdate);
+  }
+  frame_prefix_ = frame_.size();
+}
+
+void InputRenderer::end_frame() {
+  if (frame_.size() == frame_prefix_) {
+    frame_.clear();
+    return;
+  }
+
+  if (synchronized_output_) {
+    frame_.append(ansi::kEndSynchronizedUpdate);
+  }
+  console_.emit(frame_);
+  console_.flush();
+}
+
+void InputRenderer::build(const InputFrame& frame) {
+  const LineText line = line_of(frame);
+  const std::size_t cursor = std::min(frame.cursor, line.size());
+  const std::size_t prompt_width = display_width(frame.prompt);
+
+  std::size_t start = 0;
+  LineText visible = line;
+  std::string_view ghost = ghost_suffix(frame.autosuggestion, line);
+  if (columns_ != 0U) {
+    // The last column stays empty, so the cursor never wraps to the next row.
+    const std::size_t room = columns_ > prompt_width + 1U ? columns_ - prompt_width - 1U : 1U;
+    start = visible_start(line, cursor, room, shown_start_);
+    const LineText rest = line.from(start);
+    visible = rest.first(rest.bytes_within(room));
+    ghost = visible.size() == rest.size()
+                ? ghost.substr(0, prefix_bytes_for_width(ghost, room - visible.width()))
+                : std::string_view{};
+  }
+  const Row row{.head = visible.head, .tail = visible.tail, .ghost = ghost};
+
+  const bool repaint = !shown_valid_ || frame.prompt != shown_prompt_ || start != shown_start_;
+  std::size_t column = repaint ? build_full(frame.prompt, row) : build_incremental(row);
+  shown_start_ = start;
+  update_completion_rows(frame.completion_rows, column);
+
+  const std::size_t cursor_column = prompt_width + visible.first(cursor - start).width();
+  ansi::append_horizontal_move(frame_, column, cursor_column);
+  shown_cursor_column_ = cursor_column;
+}
+
+std::size_t InputRenderer::build_full(std::string_view prompt, const Row& row) {
+  const LineText line{.head = row.head, .tail = row.tail};
+
+  frame_.push_back('\r');
+  frame_.append(prompt);
+  line.append_to(frame_);
+  append_ghost(frame_, row.ghost);
+  frame_.append(ansi::kClearToLineEnd);
+
+  shown_valid_ = true;
+  shown_prompt_.assign(prompt);
+  shown_buffer_.clear();
+  line.append_to(shown_buffer_);
+  shown_ghost_.assign(row.ghost);
+  return display_width(prompt) + line.width() + display_width(row.ghost);
+}
+
+std::size_t InputRenderer::build_incremental(const Row& row) {
+  const LineText line{.head = row.head, .tail = row.tail};
+  const std::string_view ghost = row.ghost;
+  const std::size_t common = common_prefix_length(shown_buffer_, line);
+  const LineText typed = line.from(common);
+  const std::string_view erased = std::string_view{shown_buffer_}.substr(common);
+
+  std::size_t column = shown_cursor_column_;
+  if (typed.size() == 0U && erased.empty() && ghost == shown_ghost_) {
+    return column;
+  }
+
+  const std::size_t prompt_width = display_width(shown_prompt_);
+  const std::size_t common_column = prompt_width + line.first(common).width();
+  ansi::append_horizontal_move(frame_, column, common_column);
+  typed.append_to(frame_);
+  column = common_column + typed.width();
+
+  // Typing the characters the ghost text predicted leaves the rest of the ghost in place.
+  // Appending with no ghost text before or after leaves nothing to clear either.
+  const bool ghost_still_shown =
+      erased.empty() && ((shown_ghost_.empty() && ghost.empty()) ||
+                         (shown_ghost_.size() == typed.size() + ghost.size() &&
+                          starts_with(shown_ghost_, typed) && shown_ghost_.ends_with(ghost)));
+  if (!ghost_still_shown) {
+    append_ghost(frame_, ghost);
+    frame_.append(ansi::kClearToLineEnd);
+    column += display_width(ghost);
+  }
+
+  // Only the edited tail changes, so it is all that gets copied.
+  shown_buffer_.resize(common);
+  typed.append_to(shown_buffer_);
+  shown_ghost_.assign(ghost);
+  return column;
+}
+
+void InputRenderer::update_completion_rows(std::span<const std::string> rows,
+                                           std::size_t& column) {
+  // Rows are cut short of the last column like the input line, so none of them wraps.
+  const auto too_wide = [this](const std::string& row) { return display_width(row) >= columns_; };
+  if (columns_ != 0U && std::ranges::any_of(rows, too_wide)) {
+    fitted_rows_.assign(rows.begin(), rows.end());
+    for (std::string& row : fitted_rows_) {
+      const std::size_t fitting = prefix_bytes_for_width(row, columns_ - 1U);
+      if (fitting < row.size()) {
+        const bool styled = row.find('\033') != std::string::npos;
+        row.resize(fitting);
+        if (styled) {
+          row.append(Style::reset());
+        }
+      }
+    }
+    rows = fitted_rows_;
+  }
+
+  if (std::ranges::equal(rows, shown_completion_rows_)) {
+    return;
+  }
+
+  // Rows below the input line that the cursor is on; it returns to the input line at the end.
+  std::size_t cursor_row = 0;
+  const std::size_t shown = shown_completion_rows_.size();
+  for (std::size_t index = 0; index < rows.size(); ++index) {
+    const std::string_view line = rows[index];
+    if (index < shown) {
+      const std::string_view previous = shown_completion_rows_[index];
+      if (line == previous) {
+        continue;
+      }
+      ansi::append_cursor_sequence(frame_, index + 1U - cursor_row, 'B');
+      // Text after a style change has to be written with its style, so reuse stops before one.
+      const std::size_t common = std::min({common_prefix_length(previous, line),
+                                           previous.find('\033'), line.find('\033')});
+      ansi::append_horizontal_move(frame_, column, display_width(line.substr(0, common)));
+      frame_.append(line.substr(common));
+    } else {
+      // The row may not exist yet; a newline scrolls the screen when the cursor is on the last row.
+      if (cursor_row < index) {
+        ansi::append_cursor_sequence(frame_, index - cursor_row, 'B');
+      }
+      frame_.push_back('\n');
+      frame_.append(line);
+    }
+    frame_.append(ansi::kClearToLineEnd);
+    cursor_row = index + 1U;
+    column = display_width(line);
+  }
+
+  if (rows.size() < shown) {
+    ansi::append_cursor_sequence(frame_, rows.size() + 1U - cursor_row, 'B');
+    frame_.push_back('\r');
+    frame_.append(ansi::kClearToScreenEnd);
+    cursor_row = rows.size() + 1U;
+    column = 0;
+  }
+
+  if (cursor_row != 0U) {
+    ansi::append_cursor_sequence(frame_, cursor_row, 'A');
+  }
+  shown_completion_rows_.assign(rows.begin(), rows.end());
+}
+
+} // namespace opentui
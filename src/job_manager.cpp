@@ -0,0 +1,195 @@
+#include "opentui/job_manager.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <utility>
+
+#include "opentui/console.hpp"
+
+namespace opentui {
+namespace {
+
+constexpr std::array<std::string_view, 4> kStateNames = {"Running", "Done", "Failed", "Cancelled"};
+
+[[nodiscard]] Color state_color(const JobState state) noexcept {
+  switch (state) {
+  case JobState::Done:
+    return Color::BrightGreen;
+  case JobState::Failed:
+    return Color::BrightRed;
+  case JobState::Cancelled:
+    return Color::BrightYellow;
+  case JobState::Running:
+    break;
+  }
+  return Color::BrightBlack;
+}
+
+} // namespace
+
+std::string_view job_state_name(const JobState state) noexcept {
+  return kStateNames[static_cast<std::size_t>(state)];
+}
+
+std::string job_line(const std::size_t id, const std::string_view status,
+                     const std::string_view text) {
+  const std::string number = std::to_string(id);
+  std::string line;
+  line.reserve(number.size() + status.size() + text.size() + 5U);
+  line += '[';
+  line += number;
+  line += "] ";
+  if (!status.empty()) {
+    line += status;
+    line += "  ";
+  }
+  line += text;
+  return line;
+}
+
+JobManager::JobManager(Console& console) : console_(console) {}
+
+JobManager::~JobManager() {
+  stop_all();
+}
+
+std::size_t JobManager::start(std::string command, CommandTask task,
+                              const CommandContext& context) {
+  forget_finished();
+
+  auto job = std::make_unique<Job>();
+  job->id = next_id_++;
+  job->command = std::move(command);
+  Job& started = *job;
+  jobs_.push_back(std::move(job));
+
+  console_.println_color(job_line(started.id, {}, started.command), Color::BrightBlack);
+  started.thread = std::jthread([this, &started, task = std::move(task),
+                                 &running = context.running](const std::stop_token stop_token) {
+    CommandContext job_context{.console = console_, .running = running, .stop_token = stop_token};
+    try {
+      task(job_context);
+    } catch (const std::exception& error) {
+      console_.post(job_line(started.id, {}, error.what()), Style{Color::BrightRed});
+      job_context.failed = true;
+    } catch (...) {
+      job_context.failed = true;
+    }
+
+    if (job_context.failed) {
+      finish(started, JobState::Failed);
+    } else {
+      finish(started, stop_token.stop_requested() ? JobState::Cancelled : JobState::Done);
+    }
+  });
+  return started.id;
+}
+
+void JobManager::finish(Job& job, const JobState state) {
+  {
+    const std::lock_guard lock(mutex_);
+    job.state.store(state);
+  }
+  finished_.notify_all();
+  console_.post(job_line(job.id, job_state_name(state), job.command), Style{state_color(state)});
+}
+
+std::vector<JobInfo> JobManager::take_jobs() {
+  std::vector<JobInfo> jobs;
+  jobs.reserve(jobs_.size());
+  for (const std::unique_ptr<Job>& job : jobs_) {
+    jobs.push_back(JobInfo{.id = job->id, .command = job->command, .state = job->state.load()});
+  }
+  forget_finished();
+  return jobs;
+}
+
+std::optional<std::size_t> JobManager::latest_running() const {
+  const auto job = std::ranges::find_if(jobs_.rbegin(), jobs_.rend(), [](const auto& candidate) {
+    return candidate->state.load() == JobState::Running;
+  });
+  if (job == jobs_.rend()) {
+    return std::nullopt;
+  }
+  return (*job)->id;
+}
+
+bool JobManager::cancel(const std::size_t id) {
+  Job* job = find(id);
+  if (job == nullptr || job->state.load() != JobState::Running) {
+    return false;
+  }
+  return job->thread.request_stop();
+}
+
+std::optional<JobState> JobManager::wait(const std::size_t id,
+                                         const std::function<bool()>& interrupted) {
+  Job* job = find(id);
+  if (job == nullptr) {
+    return std::nullopt;
+  }
+
+  while (true) {
+    console_.drain_posted();
+    console_.flush();
+
+    std::unique_lock lock(mutex_);
+    if (finished_.wait_for(lock, kWaitPollInterval,
+                           [job] { return job->state.load() != JobState::Running; })) {
+      break;
+    }
+    lock.unlock();
+
+    if (interrupted && interrupted()) {
+      job->thread.request_stop();
+    }
+  }
+
+  // The job posts its final line just after its state changes.
+  if (job->thread.joinable()) {
+    job->thread.join();
+  }
+  console_.drain_posted();
+  console_.flush();
+  return job->state.load();
+}
+
+void JobManager::stop_all() {
+  for (const std::unique_ptr<Job>& job : jobs_) {
+    job->thread.request_stop();
+  }
+  for (const std::unique_ptr<Job>& job : jobs_) {
+    if (job->thread.joinable()) {
+      job->thread.join();
+    }
+  }
+  jobs_.clear();
+}
+
+std::size_t JobManager::running() const {
+  return static_cast<std::size_t>(std::ranges::count_if(jobs_, [](const auto& job) {
+    return job->state.load() == JobState::Running;
+  }));
+}
+
+JobManager::Job* JobManager::find(const std::size_t id) const {
+  const auto job =
+      std::ranges::find_if(jobs_, [id](const auto& candidate) { return candidate->id == id; });
+  return job == jobs_.end() ? nullptr : job->get();
+}
+
+void JobManager::forget_finished() {
+  std::erase_if(jobs_, [](const std::unique_ptr<Job>& job) {
+    if (job->state.load() == JobState::Running) {
+      return false;
+    }
+    // Finished tasks have returned; joining only waits out the final post().
+    if (job->thread.joinable()) {
+      job->thread.join();
+    }
+    return true;
+  });
+}
+
+} // namespace opentui
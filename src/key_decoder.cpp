@@ -0,0 +1,286 @@
+#include "opentui/key_decoder.hpp"
+
+#include <algorithm>
+
+namespace opentui {
+namespace {
+
+constexpr char kEscape = '\033';
+constexpr std::string_view kPasteEnd = "\033[201~";
+constexpr unsigned kPasteBeginParameter = 200;
+
+[[nodiscard]] unsigned first_parameter(std::string_view parameters) {
+  unsigned value = 0;
+  for (const char character : parameters) {
+    if (character < '0' || character > '9') {
+      break;
+    }
+    value = (value * 10U) + static_cast<unsigned>(character - '0');
+  }
+  return value;
+}
+
+[[nodiscard]] KeyCode csi_key(std::string_view parameters, const char final_byte) {
+  switch (final_byte) {
+  case 'A':
+    return KeyCode::Up;
+  case 'B':
+    return KeyCode::Down;
+  case 'C':
+    return KeyCode::Right;
+  case 'D':
+    return KeyCode::Left;
+  case 'H':
+    return KeyCode::Home;
+  case 'F':
+    return KeyCode::End;
+  case 'Z':
+    return KeyCode::BackTab;
+  case '~':
+    break;
+  default:
+    return KeyCode::Unknown;
+  }
+
+  switch (first_parameter(parameters)) {
+  case 1U:
+  case 7U:
+    return KeyCode::Home;
+  case 2U:
+    return KeyCode::Insert;
+  case 3U:
+    return KeyCode::Delete;
+  case 4U:
+  case 8U:
+    return KeyCode::End;
+  case 5U:
+    return KeyCode::PageUp;
+  case 6U:
+    return KeyCode::PageDown;
+  default:
+    return KeyCode::Unknown;
+  }
+}
+
+[[nodiscard]] KeyCode ss3_key(const char final_byte) {
+  switch (final_byte) {
+  case 'A':
+    return KeyCode::Up;
+  case 'B':
+    return KeyCode::Down;
+  case 'C':
+    return KeyCode::Right;
+  case 'D':
+    return KeyCode::Left;
+  case 'H':
+    return KeyCode::Home;
+  case 'F':
+    return KeyCode::End;
+  default:
+    return KeyCode::Unknown;
+  }
+}
+
+[[nodiscard]] bool in_range(const char character, const unsigned char first,
+                            const unsigned char last) {
+  const auto byte = static_cast<unsigned char>(character);
+  return byte >= first && byte <= last;
+}
+
+[[nodiscard]] bool is_text_byte(const char character) {
+  const auto byte = static_cast<unsigned char>(character);
+  return byte >= 0x20U && byte != 0x7FU;
+}
+
+// Number of trailing bytes that form the start of a UTF-8 sequence still waiting for the rest.
+[[nodiscard]] std::size_t incomplete_utf8_tail(std::string_view text) {
+  const std::size_t lookback = std::min<std::size_t>(text.size(), 3U);
+  for (std::size_t back = 1; back <= lookback; ++back) {
+    const auto byte = static_cast<unsigned char>(text[text.size() - back]);
+    if ((byte & 0xC0U) == 0x80U) {
+      continue;
+    }
+
+    std::size_t expected = 1;
+    if ((byte & 0xE0U) == 0xC0U) {
+      expected = 2;
+    } else if ((byte & 0xF0U) == 0xE0U) {
+      expected = 3;
+    } else if ((byte & 0xF8U) == 0xF0U) {
+      expected = 4;
+    }
+    return expected > back ? back : 0U;
+  }
+  return 0U;
+}
+
+} // namespace
+
+void KeyDecoder::feed(std::string_view bytes) {
+  if (position_ != 0U) {
+    input_.erase(0, position_);
+    position_ = 0;
+  }
+  input_.append(bytes);
+}
+
+std::optional<KeyEvent> KeyDecoder::next() {
+  if (paste_delivered_) {
+    paste_.clear();
+    paste_delivered_ = false;
+  }
+
+  while (true) {
+    if (in_paste_) {
+      return next_in_paste();
+    }
+    if (position_ >= input_.size()) {
+      return std::nullopt;
+    }
+
+    const char byte = input_[position_];
+    if (byte == kEscape) {
+      KeyEvent event;
+      if (decode_escape(event) == Sequence::Incomplete) {
+        return std::nullopt;
+      }
+      if (in_paste_) {
+        continue;
+      }
+      return event;
+    }
+
+    if (is_text_byte(byte)) {
+      const KeyEvent event = decode_text();
+      if (event.text.empty()) {
+        return std::nullopt;
+      }
+      return event;
+    }
+
+    ++position_;
+    switch (byte) {
+    case '\r':
+      if (position_ < input_.size() && input_[position_] == '\n') {
+        ++position_;
+      }
+      return KeyEvent{.code = KeyCode::Enter};
+    case '\n':
+      return KeyEvent{.code = KeyCode::Enter};
+    case '\t':
+      return KeyEvent{.code = KeyCode::Tab};
+    case '\b':
+    case '\x7F':
+      return KeyEvent{.code = KeyCode::Backspace};
+    default:
+      break;
+    }
+
+    if (byte >= 1 && byte <= 26) {
+      return KeyEvent{.code = KeyCode::Control, .control = static_cast<char>('a' + byte - 1)};
+    }
+    return KeyEvent{.code = KeyCode::Unknown};
+  }
+}
+
+bool KeyDecoder::escape_pending() const noexcept {
+  return !in_paste_ && input_.size() - position_ == 1U && input_[position_] == kEscape;
+}
+
+std::optional<KeyEvent> KeyDecoder::take_escape() {
+  if (!escape_pending()) {
+    return std::nullopt;
+  }
+  ++position_;
+  return KeyEvent{.code = KeyCode::Escape};
+}
+
+bool KeyDecoder::in_paste() const noexcept {
+  return in_paste_;
+}
+
+std::optional<KeyEvent> KeyDecoder::next_in_paste() {
+  const std::string_view pending = std::string_view{input_}.substr(position_);
+  const std::size_t end = pending.find(kPasteEnd);
+  if (end == std::string_view::npos) {
+    // Hold back enough bytes to recognize an end marker split across reads.
+    const std::size_t keep = std::min(pending.size(), kPasteEnd.size() - 1U);
+    paste_.append(pending.substr(0, pending.size() - keep));
+    position_ += pending.size() - keep;
+    return std::nullopt;
+  }
+
+  paste_.append(pending.substr(0, end));
+  position_ += end + kPasteEnd.size();
+  in_paste_ = false;
+  paste_delivered_ = true;
+  return KeyEvent{.code = KeyCode::Paste, .text = paste_};
+}
+
+KeyDecoder::Sequence KeyDecoder::decode_escape(KeyEvent& event) {
+  const std::string_view pending = std::string_view{input_}.substr(position_);
+  if (pending.size() < 2U) {
+    return Sequence::Incomplete;
+  }
+
+  if (pending[1] == '[') {
+    std::size_t index = 2;
+    while (index < pending.size() && in_range(pending[index], 0x30U, 0x3FU)) {
+      ++index;
+    }
+    const std::string_view parameters = pending.substr(2, index - 2U);
+    while (index < pending.size() && in_range(pending[index], 0x20U, 0x2FU)) {
+      ++index;
+    }
+    if (index >= pending.size()) {
+      return Sequence::Incomplete;
+    }
+
+    const char final_byte = pending[index];
+    if (!in_range(final_byte, 0x40U, 0x7EU)) {
+      // Malformed: report the ESC on its own and decode the rest as ordinary input.
+      ++position_;
+      event.code = KeyCode::Escape;
+      return Sequence::Complete;
+    }
+
+    position_ += index + 1U;
+    event.code = csi_key(parameters, final_byte);
+    if (final_byte == '~' && first_parameter(parameters) == kPasteBeginParameter) {
+      in_paste_ = true;
+    }
+    return Sequence::Complete;
+  }
+
+  if (pending[1] == 'O') {
+    if (pending.size() < 3U) {
+      return Sequence::Incomplete;
+    }
+    position_ += 3U;
+    event.code = ss3_key(pending[2]);
+    return Sequence::Complete;
+  }
+
+  // ESC followed by an ordinary key (Alt+key, or Escape typed ahead of other input).
+  ++position_;
+  event.code = KeyCode::Escape;
+  return Sequence::Complete;
+}
+
+KeyEvent KeyDecoder::decode_text() {
+  const std::size_t start = position_;
+  std::size_t end = start;
+  while (end < input_.size() && is_text_byte(input_[end])) {
+    ++end;
+  }
+
+  std::string_view text = std::string_view{input_}.substr(start, end - start);
+  if (end == input_.size()) {
+    text.remove_suffix(incomplete_utf8_tail(text));
+  }
+
+  position_ += text.size();
+  return KeyEvent{.code = KeyCode::Text, .text = text};
+}
+
+} // namespace opentui
@@ -2,12 +2,31 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
 #include <iostream>
+#include <iterator>
+#include <span>
+#include <string>
+#include <utility>
+
+#include "opentui/ansi.hpp"
+#include "opentui/console.hpp"
+#include "opentui/display_width.hpp"
+#include "opentui/fuzzy_matcher.hpp"
+#include "opentui/gap_buffer.hpp"
 
 #if defined(_WIN32)
+#include <chrono>
+#include <thread>
+
 #include <conio.h>
 #include <io.h>
 #else
+#include <array>
+#include <cerrno>
+#include <csignal>
+
+#include <poll.h>
 #include <termios.h>
 #include <unistd.h>
 #endif
@@ -15,65 +34,128 @@
 namespace opentui {
 namespace {
 
-void redraw(std::string_view prompt, std::string_view buffer, std::string_view autosuggestion = {},
-            std::string_view completion_line = {}) {
-  const auto draw_input_line = [&]() {
-    std::cout << '\r' << prompt << buffer;
+void ring_bell(Console& console) {
+  console.emit("\a");
+  console.flush();
+}
 
-    if (!autosuggestion.empty() && autosuggestion.size() > buffer.size() &&
-        autosuggestion.starts_with(buffer)) {
-      const std::string_view suffix = autosuggestion.substr(buffer.size());
-      std::cout << "\033[90m" << suffix << "\033[0m";
-      std::cout << "\033[" << suffix.size() << "D";
-    }
+#if !defined(_WIN32)
+// While alive, reports SIGWINCH through resized(), a WakeupSignal: notifying one only writes to a
+// pipe, so the handler may do it.
+class ResizeWatcher {
+public:
+  ResizeWatcher() {
+    static_cast<void>(resized());
+    struct sigaction action{};
+    action.sa_handler = &ResizeWatcher::on_resize;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    enabled_ = sigaction(SIGWINCH, &action, &previous_) == 0;
+  }
 
-    std::cout << "\033[K";
-  };
+  ~ResizeWatcher() {
+    if (enabled_) {
+      sigaction(SIGWINCH, &previous_, nullptr);
+    }
+  }
 
-  draw_input_line();
-  std::cout << '\n' << completion_line << "\033[K";
-  std::cout << "\033[1A";
-  draw_input_line();
-  std::cout << std::flush;
-}
+  ResizeWatcher(const ResizeWatcher&) = delete;
+  ResizeWatcher& operator=(const ResizeWatcher&) = delete;
 
-[[nodiscard]] std::string normalize_candidate_for_display(std::string candidate) {
-  while (!candidate.empty() && std::isspace(static_cast<unsigned char>(candidate.back())) != 0) {
-    candidate.pop_back();
+  // Created before the handler is first installed, so the handler never constructs it.
+  [[nodiscard]] static WakeupSignal& resized() {
+    static WakeupSignal signal;
+    return signal;
   }
 
-  constexpr std::size_t kMaxCandidateLength = 32;
-  if (candidate.size() > kMaxCandidateLength) {
-    candidate = candidate.substr(0, kMaxCandidateLength - 3U) + "...";
+private:
+  static void on_resize(const int signal_number) noexcept {
+    static_cast<void>(signal_number);
+    resized().notify();
   }
 
-  return candidate;
-}
+  struct sigaction previous_{};
+  bool enabled_{false};
+};
+#endif
 
-[[nodiscard]] std::string format_completion_line(const std::vector<std::string>& candidates) {
-  if (candidates.empty()) {
-    return {};
-  }
+enum class Wakeup { Key, Posted, Completion, Resize };
 
-  constexpr std::size_t kMaxShownCandidates = 8;
-  std::string line = "completions: ";
+// Blocks until a key is available, another thread has posted console output that should be
+// printed above the prompt, a background completion request has finished or the terminal has
+// been resized away from `columns`.
+[[nodiscard]] Wakeup wait_for_input(Console& console, const WakeupSignal& completion_ready,
+                                    const std::size_t columns) {
+#if defined(_WIN32)
+  while (true) {
+    if (console.has_posted()) {
+      return Wakeup::Posted;
+    }
+    if (completion_ready.pending()) {
+      return Wakeup::Completion;
+    }
+    if (_kbhit() != 0) {
+      return Wakeup::Key;
+    }
+    if (ansi::terminal_columns() != columns) {
+      return Wakeup::Resize;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+#else
+  std::array<pollfd, 4> descriptors{{
+      {.fd = STDIN_FILENO, .events = POLLIN, .revents = 0},
+      {.fd = console.wakeup().native_handle(), .events = POLLIN, .revents = 0},
+      {.fd = completion_ready.native_handle(), .events = POLLIN, .revents = 0},
+      {.fd = ResizeWatcher::resized().native_handle(), .events = POLLIN, .revents = 0},
+  }};
+  static_cast<void>(columns);
+
+  while (!console.has_posted()) {
+    if (poll(descriptors.data(), descriptors.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return Wakeup::Key;
+    }
 
-  const std::size_t limit = std::min(kMaxShownCandidates, candidates.size());
-  for (std::size_t index = 0; index < limit; ++index) {
-    if (index != 0U) {
-      line += "  ";
+    if ((descriptors[0].revents & (POLLIN | POLLHUP | POLLERR)) != 0) {
+      return Wakeup::Key;
+    }
+    if ((descriptors[2].revents & POLLIN) != 0) {
+      return Wakeup::Completion;
+    }
+    if ((descriptors[3].revents & POLLIN) != 0) {
+      ResizeWatcher::resized().consume();
+      return Wakeup::Resize;
     }
-    line += normalize_candidate_for_display(candidates[index]);
+    console.wakeup().consume();
   }
+  return Wakeup::Posted;
+#endif
+}
 
-  if (candidates.size() > kMaxShownCandidates) {
-    line += "  ...";
+// Binds the provider to the worker for one read_line() call. The worker is drained on the way
+// out so the provider never runs concurrently with the command handler that follows.
+class CompletionSession {
+public:
+  CompletionSession(CompletionWorker& worker, const CompletionWorker::Provider& provider)
+      : worker_(worker) {
+    worker_.set_provider(provider);
   }
 
-  return line;
-}
+  ~CompletionSession() {
+    worker_.cancel_and_wait();
+  }
 
-[[nodiscard]] std::string longest_common_prefix(const std::vector<std::string>& values) {
+  CompletionSession(const CompletionSession&) = delete;
+  CompletionSession& operator=(const CompletionSession&) = delete;
+
+private:
+  CompletionWorker& worker_;
+};
+
+[[nodiscard]] std::string longest_common_prefix(std::span<const std::string> values) {
   if (values.empty()) {
     return {};
   }
@@ -96,29 +178,111 @@ void redraw(std::string_view prompt, std::string_view buffer, std::string_view a
   return prefix;
 }
 
-[[nodiscard]] std::string
-autosuggestion_for(const std::string_view buffer, const std::vector<std::string>& history,
-                   const std::vector<std::string>& completion_candidates) {
+// Completion candidates as shown for the current buffer: all of `all`, or only the entries at
+// `indices` while the buffer has moved on from the one they were computed for.
+struct CandidateView {
+  std::span<const std::string> all;
+  std::span<const std::uint32_t> indices{};
+  bool filtered{false};
+
+  [[nodiscard]] std::size_t size() const noexcept {
+    return filtered ? indices.size() : all.size();
+  }
+  [[nodiscard]] const std::string& operator[](const std::size_t index) const {
+    return filtered ? all[indices[index]] : all[index];
+  }
+};
+
+[[nodiscard]] std::string autosuggestion_for(const std::string_view buffer, const History& history,
+                                             const CandidateView& completion_candidates) {
   if (buffer.empty()) {
     return {};
   }
 
-  for (const auto& candidate : completion_candidates) {
+  for (std::size_t index = 0; index < completion_candidates.size(); ++index) {
+    const std::string& candidate = completion_candidates[index];
     if (candidate.size() > buffer.size() && std::string_view{candidate}.starts_with(buffer)) {
       return candidate;
     }
   }
 
-  for (auto iterator = history.rbegin(); iterator != history.rend(); ++iterator) {
-    if (iterator->size() > buffer.size() && std::string_view{*iterator}.starts_with(buffer)) {
-      return *iterator;
-    }
+  if (const std::optional<std::size_t> index = history.newest_extending(buffer)) {
+    return std::string{history[*index]};
   }
 
   return {};
 }
 
+[[nodiscard]] std::string reverse_search_prompt(std::string_view query, const bool failed) {
+  std::string prompt = failed ? "(failed reverse-i-search)`" : "(reverse-i-search)`";
+  prompt += query;
+  prompt += "': ";
+  return prompt;
+}
+
+void pop_codepoint(std::string& buffer) {
+  while (!buffer.empty() && (static_cast<unsigned char>(buffer.back()) & 0xC0U) == 0x80U) {
+    buffer.pop_back();
+  }
+  if (!buffer.empty()) {
+    buffer.pop_back();
+  }
+}
+
 #if !defined(_WIN32)
+constexpr std::size_t kReadChunkSize = 4096;
+// An ESC not followed by the rest of a sequence within this window is a lone Escape key.
+constexpr int kEscapeTimeoutMilliseconds = 25;
+
+[[nodiscard]] bool input_ready_within(const int timeout_milliseconds) {
+  pollfd descriptor{.fd = STDIN_FILENO, .events = POLLIN, .revents = 0};
+  while (true) {
+    const int ready = poll(&descriptor, 1, timeout_milliseconds);
+    if (ready < 0 && errno == EINTR) {
+      continue;
+    }
+    return ready > 0;
+  }
+}
+
+// The editor holds a single line, so line breaks and tabs in pasted text become spaces and other
+// control characters are dropped.
+[[nodiscard]] std::string pasted_text_for_line(std::string_view text) {
+  std::string line;
+  line.reserve(text.size());
+  for (std::size_t index = 0; index < text.size(); ++index) {
+    const char character = text[index];
+    if (character == '\r' && index + 1U < text.size() && text[index + 1U] == '\n') {
+      continue;
+    }
+    if (character == '\r' || character == '\n' || character == '\t') {
+      line.push_back(' ');
+    } else if (static_cast<unsigned char>(character) >= 0x20U && character != '\x7F') {
+      line.push_back(character);
+    }
+  }
+  return line;
+}
+
+class BracketedPasteGuard {
+public:
+  explicit BracketedPasteGuard(Console& console) : console_(console) {
+    console_.emit(KeyDecoder::kEnableBracketedPaste);
+    console_.flush();
+  }
+
+  ~BracketedPasteGuard() {
+    console_.emit(KeyDecoder::kDisableBracketedPaste);
+    console_.flush();
+  }
+
+  BracketedPasteGuard(const BracketedPasteGuard&) = delete;
+  BracketedPasteGuard& operator=(const BracketedPasteGuard&) = delete;
+
+private:
+  Console& console_;
+};
+
 class RawModeGuard {
 public:
   RawModeGuard() {
@@ -158,58 +322,275 @@ private:
 
 } // namespace
 
+LineEditor::LineEditor(Console& console) : console_(console), renderer_(console) {
+  renderer_.set_metrics(&metrics_);
+}
+
+bool LineEditor::set_history_file(const std::filesystem::path& path) {
+  return history_.open_file(path);
+}
+
+History& LineEditor::history() noexcept {
+  return history_;
+}
+
+InputMetrics& LineEditor::input_metrics() noexcept {
+  return metrics_;
+}
+
+void LineEditor::set_completion_deadline(const std::chrono::milliseconds deadline) noexcept {
+  completion_deadline_ = deadline;
+}
+
+void LineEditor::set_completion_menu_height(const std::size_t rows) noexcept {
+  completion_menu_height_ = rows;
+}
+
 std::optional<std::string> LineEditor::read_line(std::string_view prompt,
                                                  const CompletionProvider& completion_provider) {
-  const auto push_history = [this](const std::string& line) {
-    if (line.empty()) {
-      return;
-    }
-
-    if (!history_.empty() && history_.back() == line) {
-      return;
-    }
+  // The whole list comes back as its first page, so no further pages are asked for.
+  return read_line(prompt, [&completion_provider](
+                               const std::string_view buffer, const std::size_t offset,
+                               const std::size_t count, const std::stop_token& stop_token) {
+    static_cast<void>(offset);
+    static_cast<void>(count);
+    static_cast<void>(stop_token);
+    std::vector<std::string> candidates = completion_provider(buffer);
+    const std::size_t total = candidates.size();
+    return CompletionPage{.candidates = std::move(candidates), .offset = 0, .total = total};
+  });
+}
 
-    history_.push_back(line);
-    if (history_.size() > kMaxHistoryEntries) {
-      history_.erase(history_.begin());
-    }
-  };
+std::optional<std::string>
+LineEditor::read_line(std::string_view prompt, const CompletionPageProvider& completion_provider) {
+  console_.drain_posted();
+  console_.flush();
 
   if (!is_interactive()) {
     std::string line;
     if (!std::getline(std::cin, line)) {
       return std::nullopt;
     }
-    push_history(line);
+    history_.add(line);
     return line;
   }
 
-  std::cout << prompt << std::flush;
-  std::string buffer;
+  renderer_.set_columns(ansi::terminal_columns());
+  renderer_.render(InputFrame{.prompt = prompt});
+  GapBuffer buffer;
   std::string draft_buffer;
   std::size_t history_index = history_.size();
 
-  const auto redraw_with_suggestions = [this, &buffer, &completion_provider, prompt]() {
-    if (buffer.empty()) {
-      redraw(prompt, buffer);
+  const CompletionSession completion_session(completion_worker_, completion_provider);
+  // Newest candidates received from the worker and the buffer they were computed for. They are
+  // the first pages of a list of `candidates_total`.
+  std::vector<std::string> candidates;
+  std::size_t candidates_total = 0;
+  std::string candidates_buffer;
+  std::uint64_t requested_generation = 0;
+  std::string requested_buffer;
+  std::size_t requested_offset = 0;
+
+  // The candidates indexed for fuzzy search, and the indices of those that still match
+  // `stale_buffer`, best first, for when the buffer has moved on from `candidates_buffer`.
+  // Searched again only when either changes, so redraws and menu moves do not copy candidates.
+  FuzzyIndex candidate_index;
+  std::vector<std::uint32_t> stale_indices;
+  std::optional<std::string> stale_buffer;
+
+  const auto apply_result = [&candidates, &candidates_total, &candidates_buffer, &candidate_index,
+                             &stale_buffer](CompletionResult result) {
+    if (result.error) {
+      std::rethrow_exception(result.error);
+    }
+    if (result.offset == 0U) {
+      candidates = std::move(result.candidates);
+      candidates_buffer = std::move(result.buffer);
+      candidate_index.assign(candidates);
+    } else if (result.buffer == candidates_buffer && result.offset == candidates.size()) {
+      for (std::string& candidate : result.candidates) {
+        candidate_index.add(candidate);
+        candidates.push_back(std::move(candidate));
+      }
+    } else {
       return;
     }
+    candidates_total = std::max(result.total, candidates.size());
+    stale_buffer.reset();
+  };
 
-    const auto completion_candidates = completion_provider(buffer);
-    const std::string autosuggestion = autosuggestion_for(buffer, history_, completion_candidates);
-    const std::string completion_line = format_completion_line(completion_candidates);
+  // Makes `candidates` current for the buffer, waiting at most `deadline` for the worker. Returns
+  // false if the request is still running; its result arrives later through the wakeup signal.
+  const auto refresh_candidates = [this, &buffer, &candidates, &candidates_total,
+                                   &candidates_buffer, &candidate_index, &stale_buffer,
+                                   &requested_generation, &requested_buffer, &requested_offset,
+                                   &apply_result](const std::chrono::milliseconds deadline) {
+    const std::string_view text = buffer.text();
+    if (text.empty()) {
+      candidates.clear();
+      candidates_total = 0;
+      candidates_buffer.clear();
+      candidate_index.assign({});
+      stale_buffer.reset();
+      return true;
+    }
+    if (candidates_buffer == text) {
+      return true;
+    }
 
-    redraw(prompt, buffer, autosuggestion, completion_line);
+    if (requested_generation == 0U || requested_buffer != text || requested_offset != 0U) {
+      requested_buffer = text;
+      requested_offset = 0;
+      requested_generation =
+          completion_worker_.request(requested_buffer, requested_offset, kCompletionPageSize);
+    }
+    if (auto result = completion_worker_.wait_for(requested_generation, deadline)) {
+      apply_result(std::move(*result));
+      return true;
+    }
+    return false;
   };
 
-  const auto move_history_up = [this, &buffer, &draft_buffer, &history_index,
-                                &redraw_with_suggestions]() {
+  // Asks for up to `count` more of the current candidates, waiting at most `deadline`. Returns
+  // false if they are still on their way.
+  const auto load_more_candidates = [this, &buffer, &candidates, &candidates_total,
+                                     &candidates_buffer, &requested_generation,
+                                     &requested_buffer, &requested_offset,
+                                     &apply_result](const std::size_t count,
+                                                    const std::chrono::milliseconds deadline) {
+    const std::string_view text = buffer.text();
+    if (candidates_buffer != text || candidates.size() >= candidates_total) {
+      return true;
+    }
+
+    if (requested_buffer != text || requested_offset != candidates.size()) {
+      requested_buffer = text;
+      requested_offset = candidates.size();
+      requested_generation = completion_worker_.request(requested_buffer, requested_offset, count);
+    }
+    if (auto result = completion_worker_.wait_for(requested_generation, deadline)) {
+      apply_result(std::move(*result));
+      return true;
+    }
+    return false;
+  };
+
+  // Candidates to display: current ones, or the last good ones that still fit the buffer.
+  const auto visible_candidates = [&buffer, &candidates, &candidates_buffer, &candidate_index,
+                                   &stale_indices, &stale_buffer]() {
+    const std::string_view text = buffer.text();
+    if (candidates_buffer == text) {
+      return CandidateView{.all = candidates};
+    }
+    if (stale_buffer != text) {
+      stale_indices.clear();
+      for (const FuzzyMatch& match : candidate_index.search(text, candidate_index.size())) {
+        stale_indices.push_back(static_cast<std::uint32_t>(match.index));
+      }
+      stale_buffer = text;
+    }
+    return CandidateView{.all = candidates, .indices = stale_indices, .filtered = true};
+  };
+
+  // The menu lists the visible candidates while typing at the end of the line. Tab with nothing
+  // left to complete, or Down below the newest history entry, selects in it; the selection is
+  // dropped whenever the line changes.
+  CompletionMenu menu(completion_menu_height_);
+  std::vector<std::string> menu_rows;
+  std::string menu_buffer;
+
+  // Reverse incremental search (Ctrl-R): while active the prompt shows the query and the buffer
+  // holds the matching history entry at `search_match`, or history_.size() before any match.
+  bool searching = false;
+  bool search_failed = false;
+  std::string search_query;
+  std::size_t search_match = 0;
+  std::string search_original;
+
+  const auto redraw_with_suggestions = [this, &buffer, &candidates_total, &refresh_candidates,
+                                        &visible_candidates, &menu, &menu_rows, &menu_buffer,
+                                        &searching, &search_query, &search_failed, prompt]() {
+    if (searching) {
+      const std::string search_prompt = reverse_search_prompt(search_query, search_failed);
+      renderer_.render(InputFrame{.prompt = search_prompt,
+                                  .buffer = buffer.before_gap(),
+                                  .buffer_tail = buffer.after_gap()});
+      return;
+    }
+    // Suggestions describe the whole line, so they are only offered while typing at its end.
+    // Elsewhere the line is drawn from both sides of the gap, which then stays where the edits are.
+    if (buffer.empty() || !buffer.cursor_at_end()) {
+      renderer_.render(InputFrame{.prompt = prompt,
+                                  .buffer = buffer.before_gap(),
+                                  .buffer_tail = buffer.after_gap(),
+                                  .cursor = buffer.cursor()});
+      return;
+    }
+
+    const std::string_view text = buffer.text();
+
+    StageTimer completion_timer(&metrics_, InputStage::Completion);
+    static_cast<void>(refresh_candidates(completion_deadline_));
+    const CandidateView completion_candidates = visible_candidates();
+    completion_timer.stop();
+
+    StageTimer autosuggestion_timer(&metrics_, InputStage::Autosuggestion);
+    const std::string autosuggestion = autosuggestion_for(text, history_, completion_candidates);
+    autosuggestion_timer.stop();
+    if (menu_buffer != text) {
+      menu.reset();
+      menu_buffer = text;
+    }
+    if (completion_candidates.filtered) {
+      menu.build_rows(completion_candidates.all, completion_candidates.indices, menu_rows);
+    } else {
+      menu.build_rows(completion_candidates.all, menu_rows, candidates_total);
+    }
+
+    renderer_.render(InputFrame{.prompt = prompt,
+                                .buffer = text,
+                                .autosuggestion = autosuggestion,
+                                .completion_rows = menu_rows});
+  };
+
+  const auto receive_completion = [this, &apply_result, &redraw_with_suggestions]() {
+    completion_worker_.wakeup().consume();
+    if (auto result = completion_worker_.take_result()) {
+      apply_result(std::move(*result));
+      redraw_with_suggestions();
+    }
+  };
+
+  const auto print_posted = [this, &redraw_with_suggestions]() {
+    console_.wakeup().consume();
+    renderer_.clear();
+    console_.drain_posted();
+    redraw_with_suggestions();
+  };
+
+  // The line is drawn to fit the new width from scratch, since the terminal may have rewrapped
+  // what was on screen.
+  const auto resize = [this, &redraw_with_suggestions]() {
+    renderer_.set_columns(ansi::terminal_columns());
+    renderer_.clear();
+    redraw_with_suggestions();
+  };
+
+  // Edits only mark the line dirty; it is redrawn once after every key in the current read has
+  // been applied.
+  bool dirty = false;
+  const auto edited = [this, &history_index, &dirty]() {
+    history_index = history_.size();
+    dirty = true;
+  };
+
+  const auto move_history_up = [this, &buffer, &draft_buffer, &history_index, &dirty]() {
     if (history_.empty()) {
       return false;
     }
 
     if (history_index == history_.size()) {
-      draft_buffer = buffer;
+      draft_buffer = buffer.text();
     }
 
     if (history_index == 0U) {
@@ -217,156 +598,316 @@ std::optional<std::string> LineEditor::read_line(std::string_view prompt,
     }
 
     --history_index;
-    buffer = history_[history_index];
-    redraw_with_suggestions();
+    buffer.assign(history_[history_index]);
+    dirty = true;
     return true;
   };
 
-  const auto move_history_down = [this, &buffer, &draft_buffer, &history_index,
-                                  &redraw_with_suggestions]() {
+  const auto move_history_down = [this, &buffer, &draft_buffer, &history_index, &dirty]() {
     if (history_.empty() || history_index == history_.size()) {
       return false;
     }
 
     ++history_index;
     if (history_index == history_.size()) {
-      buffer = draft_buffer;
+      buffer.assign(draft_buffer);
     } else {
-      buffer = history_[history_index];
+      buffer.assign(history_[history_index]);
     }
 
-    redraw_with_suggestions();
+    dirty = true;
     return true;
   };
 
-  const auto accept_autosuggestion = [this, &buffer, &history_index, &draft_buffer,
-                                      &completion_provider, &redraw_with_suggestions]() {
-    const auto completion_candidates = completion_provider(buffer);
-    const std::string suggestion = autosuggestion_for(buffer, history_, completion_candidates);
+  // Accepts the suggestion as displayed rather than waiting for fresher candidates.
+  const auto accept_autosuggestion = [this, &buffer, &visible_candidates, &edited]() {
+    const CandidateView completion_candidates = visible_candidates();
+    const std::string_view text = buffer.text();
+    const std::string suggestion = autosuggestion_for(text, history_, completion_candidates);
 
-    if (suggestion.empty() || suggestion.size() <= buffer.size() ||
-        !std::string_view{suggestion}.starts_with(buffer)) {
+    if (suggestion.empty() || suggestion.size() <= text.size() ||
+        !std::string_view{suggestion}.starts_with(text)) {
       return false;
     }
 
-    buffer = suggestion;
-    history_index = history_.size();
-    draft_buffer = buffer;
-    redraw_with_suggestions();
+    buffer.assign(suggestion);
+    edited();
     return true;
   };
 
-  const auto finalize_line = [this, &buffer, &push_history, prompt]() {
-    redraw(prompt, buffer);
-    std::cout << '\n';
-    push_history(buffer);
-    return std::optional<std::string>{buffer};
+  const auto move_cursor = [&dirty](const bool moved) {
+    dirty = dirty || moved;
+    return moved;
   };
 
-#if defined(_WIN32)
-  while (true) {
-    const int key = _getch();
-    if (key == 3) {
-      redraw(prompt, buffer);
-      std::cout << '\n';
-      return std::nullopt;
+  // Right moves through the line and accepts the suggestion once the cursor reaches its end.
+  const auto move_right = [&buffer, &accept_autosuggestion, &move_cursor]() {
+    if (buffer.cursor_at_end()) {
+      return accept_autosuggestion();
     }
+    return move_cursor(buffer.move_right());
+  };
 
-    if (key == '\r' || key == '\n') {
-      return finalize_line();
+  const auto move_menu = [this, &buffer, &searching, &candidates, &candidates_total,
+                          &visible_candidates, &load_more_candidates, &menu,
+                          &dirty](const std::ptrdiff_t delta) {
+    if (searching || buffer.empty() || !buffer.cursor_at_end()) {
+      return false;
+    }
+    dirty = true;
+
+    // Moving down to within a page of the last loaded candidate asks for the next page. Until it
+    // arrives the selection stays on the last row instead of wrapping to the first.
+    const std::size_t selected = menu.selected().value_or(0U);
+    if (delta > 0 && !visible_candidates().filtered && candidates.size() < candidates_total &&
+        selected + static_cast<std::size_t>(delta) + menu.height() >= candidates.size() &&
+        !load_more_candidates(kCompletionPageSize, completion_deadline_) &&
+        selected + 1U == candidates.size()) {
+      return true;
     }
+    return menu.move(delta, visible_candidates().size());
+  };
 
-    if (key == '\b' || key == 127) {
-      if (!buffer.empty()) {
-        buffer.pop_back();
-        history_index = history_.size();
-        draft_buffer = buffer;
-        redraw_with_suggestions();
-      }
-      continue;
+  const auto close_menu = [&menu, &dirty]() {
+    if (menu.selected().has_value()) {
+      menu.reset();
+      dirty = true;
     }
+  };
 
-    if (key == '\t') {
-      const auto candidates = completion_provider(buffer);
-      if (candidates.empty()) {
-        std::cout << '\a' << std::flush;
-        continue;
-      }
+  const auto accept_menu_selection = [&buffer, &visible_candidates, &menu, &edited]() {
+    const CandidateView completion_candidates = visible_candidates();
+    const std::optional<std::size_t> selected = menu.selected();
+    if (!selected.has_value() || *selected >= completion_candidates.size()) {
+      return false;
+    }
+    buffer.assign(completion_candidates[*selected]);
+    edited();
+    return true;
+  };
 
-      const std::string common_prefix = longest_common_prefix(candidates);
-      if (common_prefix.size() > buffer.size()) {
-        buffer = common_prefix;
-        history_index = history_.size();
-        draft_buffer = buffer;
-        redraw_with_suggestions();
-        continue;
-      }
+  const auto complete = [&buffer, &candidates, &candidates_total, &refresh_candidates,
+                         &load_more_candidates, &move_menu, &edited]() {
+    if (!buffer.cursor_at_end() || !refresh_candidates(kTabCompletionTimeout) ||
+        candidates.empty()) {
+      return false;
+    }
+    // Only a whole list has a common prefix or a single match to take.
+    if (candidates_total <= kMaxTabCandidates) {
+      static_cast<void>(load_more_candidates(candidates_total - candidates.size(),
+                                             kTabCompletionTimeout));
+    }
+    if (candidates.size() < candidates_total) {
+      return move_menu(1);
+    }
 
-      if (candidates.size() == 1U) {
-        buffer = candidates.front();
-        history_index = history_.size();
-        draft_buffer = buffer;
-        redraw_with_suggestions();
-        continue;
+    // Candidates extending the line literally take precedence over fuzzy matches.
+    std::vector<std::string> extending;
+    std::ranges::copy_if(candidates, std::back_inserter(extending),
+                         [text = buffer.text()](const std::string& candidate) {
+                           return std::string_view{candidate}.starts_with(text);
+                         });
+    const std::vector<std::string>& pool = extending.empty() ? candidates : extending;
+
+    const std::string common_prefix = longest_common_prefix(pool);
+    if (!extending.empty() && common_prefix.size() > buffer.size()) {
+      buffer.assign(common_prefix);
+      edited();
+    } else if (pool.size() == 1U) {
+      buffer.assign(pool.front());
+      edited();
+    } else {
+      return move_menu(1);
+    }
+    return true;
+  };
+
+  const auto insert_text = [&buffer, &edited](std::string_view text) {
+    buffer.insert(text);
+    edited();
+  };
+
+  const auto erase_before_cursor = [&buffer, &edited]() {
+    if (buffer.erase_before()) {
+      edited();
+    }
+  };
+
+  const auto erase_at_cursor = [&buffer, &edited]() {
+    if (buffer.erase_after()) {
+      edited();
+    }
+  };
+
+  // Moves to the newest entry below `before` that contains the query, optionally skipping ones
+  // identical to the match already shown.
+  const auto find_search_match = [this, &buffer, &search_query, &search_match,
+                                  &search_failed](std::size_t before, const bool skip_shown) {
+    while (const auto index = history_.search_backward(search_query, before)) {
+      if (!skip_shown || history_[*index] != buffer.text()) {
+        search_match = *index;
+        buffer.assign(history_[*index]);
+        search_failed = false;
+        return true;
       }
+      before = *index;
+    }
+    search_failed = true;
+    return false;
+  };
+
+  const auto search_older = [this, &buffer, &searching, &search_failed, &search_query,
+                             &search_match, &search_original, &find_search_match, &dirty]() {
+    dirty = true;
+    if (!searching) {
+      searching = true;
+      search_failed = false;
+      search_query.clear();
+      search_match = history_.size();
+      search_original = buffer.text();
+      return true;
+    }
+    return !search_query.empty() && find_search_match(search_match, true);
+  };
+
+  const auto search_type = [&search_query, &search_match, &find_search_match,
+                            &dirty](std::string_view text) {
+    search_query.append(text);
+    dirty = true;
+    // The shown match stays if it still contains the longer query.
+    return find_search_match(search_match + 1U, false);
+  };
+
+  const auto search_erase = [this, &buffer, &search_query, &search_match, &search_failed,
+                             &search_original, &find_search_match, &dirty]() {
+    pop_codepoint(search_query);
+    dirty = true;
+    if (search_query.empty()) {
+      search_match = history_.size();
+      search_failed = false;
+      buffer.assign(search_original);
+      return;
+    }
+    static_cast<void>(find_search_match(history_.size(), false));
+  };
 
+  const auto leave_search = [&buffer, &searching, &search_original, &edited](const bool keep) {
+    searching = false;
+    if (!keep) {
+      buffer.assign(search_original);
+    }
+    edited();
+  };
+
+  const auto finalize_line = [this, &buffer, prompt]() {
+    std::string line{buffer.text()};
+    renderer_.commit(prompt, line);
+    if (Scrollback* scrollback = console_.scrollback(); scrollback != nullptr) {
+      scrollback->append(prompt);
+      scrollback->append_line(line);
+    }
+    history_.add(line);
+    return std::optional<std::string>{std::move(line)};
+  };
+
+#if defined(_WIN32)
+  InputMetrics::Clock::time_point key_read_at{};
+  while (true) {
+    if (dirty) {
       redraw_with_suggestions();
+      dirty = false;
+      if (key_read_at != InputMetrics::Clock::time_point{}) {
+        metrics_.record_since(InputStage::KeyToPaint, key_read_at);
+      }
+    }
+    key_read_at = {};
+
+    const Wakeup wakeup =
+        wait_for_input(console_, completion_worker_.wakeup(), renderer_.columns());
+    if (wakeup == Wakeup::Posted) {
+      print_posted();
+      continue;
+    }
+    if (wakeup == Wakeup::Completion) {
+      receive_completion();
+      continue;
+    }
+    if (wakeup == Wakeup::Resize) {
+      resize();
       continue;
     }
 
-    if (key == 0 || key == 224) {
-      const int special_key = _getch();
-      if (special_key == 72) {
-        if (!move_history_up()) {
-          std::cout << '\a' << std::flush;
-        }
-        continue;
+    const int key = _getch();
+    key_read_at = InputMetrics::now();
+    if (searching) {
+      bool handled = true;
+      bool consumed = true;
+      if (key == 18) {
+        handled = search_older();
+      } else if (key == '\b' || key == 127) {
+        search_erase();
+      } else if (key == 7) {
+        leave_search(false);
+      } else if (key == 27) {
+        leave_search(true);
+      } else if (key != 0 && key != 224 && std::isprint(key) != 0) {
+        handled = search_type(std::string(1U, static_cast<char>(key)));
+      } else {
+        leave_search(true);
+        consumed = false;
       }
 
-      if (special_key == 80) {
-        if (!move_history_down()) {
-          std::cout << '\a' << std::flush;
-        }
+      if (!handled) {
+        ring_bell(console_);
+      }
+      if (consumed) {
         continue;
       }
+    }
 
-      if (special_key == 77) {
-        if (!accept_autosuggestion()) {
-          std::cout << '\a' << std::flush;
+    if (menu.selected().has_value()) {
+      bool handled = true;
+      bool consumed = true;
+      if (key == '\t') {
+        handled = move_menu(1);
+      } else if (key == '\r' || key == '\n') {
+        handled = accept_menu_selection();
+      } else if (key == 27) {
+        close_menu();
+      } else if (key == 0 || key == 224) {
+        const int special_key = _getch();
+        const auto page = static_cast<std::ptrdiff_t>(menu.height());
+        if (special_key == 80) {
+          handled = move_menu(1);
+        } else if (special_key == 72) {
+          handled = move_menu(-1);
+        } else if (special_key == 81) {
+          handled = move_menu(page);
+        } else if (special_key == 73) {
+          handled = move_menu(-page);
+        } else {
+          close_menu();
         }
-        continue;
+      } else {
+        close_menu();
+        consumed = false;
       }
 
-      continue;
-    }
-
-    if (std::isprint(key) != 0) {
-      buffer.push_back(static_cast<char>(key));
-      history_index = history_.size();
-      draft_buffer = buffer;
-      redraw_with_suggestions();
-    }
-  }
-#else
-  RawModeGuard raw_mode;
-  if (!raw_mode.enabled()) {
-    std::string line;
-    if (!std::getline(std::cin, line)) {
-      return std::nullopt;
+      if (!handled) {
+        ring_bell(console_);
+      }
+      if (consumed) {
+        continue;
+      }
     }
-    push_history(line);
-    return line;
-  }
 
-  while (true) {
-    char key = '\0';
-    if (read(STDIN_FILENO, &key, 1) != 1) {
-      return std::nullopt;
+    if (key == 18) {
+      static_cast<void>(search_older());
+      continue;
     }
 
-    if (key == 4 && buffer.empty()) {
-      redraw(prompt, buffer);
-      std::cout << '\n';
+    if (key == 3) {
+      renderer_.commit(prompt, buffer.text());
       return std::nullopt;
     }
 
@@ -375,84 +916,233 @@ std::optional<std::string> LineEditor::read_line(std::string_view prompt,
     }
 
     if (key == '\b' || key == 127) {
-      if (!buffer.empty()) {
-        buffer.pop_back();
-        history_index = history_.size();
-        draft_buffer = buffer;
-        redraw_with_suggestions();
-      }
+      erase_before_cursor();
       continue;
     }
 
     if (key == '\t') {
-      const auto candidates = completion_provider(buffer);
-      if (candidates.empty()) {
-        std::cout << '\a' << std::flush;
-        continue;
+      if (!complete()) {
+        ring_bell(console_);
       }
+      continue;
+    }
 
-      const std::string common_prefix = longest_common_prefix(candidates);
-      if (common_prefix.size() > buffer.size()) {
-        buffer = common_prefix;
-        history_index = history_.size();
-        draft_buffer = buffer;
-        redraw_with_suggestions();
-        continue;
+    if (key == 0 || key == 224) {
+      const int special_key = _getch();
+      bool handled = true;
+      if (special_key == 72) {
+        handled = move_history_up();
+      } else if (special_key == 80) {
+        handled = move_history_down() || move_menu(1);
+      } else if (special_key == 75) {
+        handled = move_cursor(buffer.move_left());
+      } else if (special_key == 77) {
+        handled = move_right();
+      } else if (special_key == 71) {
+        buffer.move_home();
+        dirty = true;
+      } else if (special_key == 79) {
+        buffer.move_end();
+        dirty = true;
+      } else if (special_key == 83) {
+        erase_at_cursor();
       }
 
-      if (candidates.size() == 1U) {
-        buffer = candidates.front();
-        history_index = history_.size();
-        draft_buffer = buffer;
-        redraw_with_suggestions();
-        continue;
+      if (!handled) {
+        ring_bell(console_);
       }
-
-      redraw_with_suggestions();
       continue;
     }
 
-    if (key == '\033') {
-      char next = '\0';
-      if (read(STDIN_FILENO, &next, 1) != 1 || next != '[') {
-        continue;
-      }
+    if (std::isprint(key) != 0) {
+      const char character = static_cast<char>(key);
+      insert_text(std::string_view{&character, 1U});
+    }
+  }
+#else
+  RawModeGuard raw_mode;
+  if (!raw_mode.enabled()) {
+    std::string line;
+    if (!std::getline(std::cin, line)) {
+      return std::nullopt;
+    }
+    history_.add(line);
+    return line;
+  }
 
-      char arrow = '\0';
-      if (read(STDIN_FILENO, &arrow, 1) != 1) {
-        continue;
-      }
+  const BracketedPasteGuard bracketed_paste(console_);
+  const ResizeWatcher resize_watcher;
+  std::array<char, kReadChunkSize> chunk{};
+  // When the keys being handled were read; unset for keys typed ahead of the prompt.
+  InputMetrics::Clock::time_point keys_read_at{};
 
-      if (arrow == 'A') {
-        if (!move_history_up()) {
-          std::cout << '\a' << std::flush;
+  while (true) {
+    // The clock restarts after each event, so Decode covers only the next() that produced one.
+    for (auto decode_start = InputMetrics::now();
+         const std::optional<KeyEvent> event = decoder_.next();
+         decode_start = InputMetrics::now()) {
+      metrics_.record_since(InputStage::Decode, decode_start);
+      bool handled = true;
+      if (searching) {
+        // Keys without a meaning in the search end it, keeping the match, and then apply as usual.
+        bool consumed = true;
+        if (event->code == KeyCode::Text || event->code == KeyCode::Paste) {
+          handled = search_type(event->text);
+        } else if (event->code == KeyCode::Backspace) {
+          search_erase();
+        } else if (event->code == KeyCode::Control && event->control == 'r') {
+          handled = search_older();
+        } else if (event->code == KeyCode::Control && event->control == 'g') {
+          leave_search(false);
+        } else {
+          leave_search(true);
+          consumed = false;
+        }
+
+        if (consumed) {
+          if (!handled) {
+            ring_bell(console_);
+          }
+          continue;
         }
-        continue;
       }
 
-      if (arrow == 'B') {
-        if (!move_history_down()) {
-          std::cout << '\a' << std::flush;
+      if (menu.selected().has_value()) {
+        // Keys without a meaning in the menu close it and then apply as usual.
+        bool consumed = true;
+        const auto page = static_cast<std::ptrdiff_t>(menu.height());
+        if (event->code == KeyCode::Tab || event->code == KeyCode::Down) {
+          handled = move_menu(1);
+        } else if (event->code == KeyCode::BackTab || event->code == KeyCode::Up) {
+          handled = move_menu(-1);
+        } else if (event->code == KeyCode::PageDown) {
+          handled = move_menu(page);
+        } else if (event->code == KeyCode::PageUp) {
+          handled = move_menu(-page);
+        } else if (event->code == KeyCode::Enter) {
+          handled = accept_menu_selection();
+        } else if (event->code == KeyCode::Escape) {
+          close_menu();
+        } else {
+          close_menu();
+          consumed = false;
+        }
+
+        if (consumed) {
+          if (!handled) {
+            ring_bell(console_);
+          }
+          continue;
         }
-        continue;
       }
 
-      if (arrow == 'C') {
-        if (!accept_autosuggestion()) {
-          std::cout << '\a' << std::flush;
+      switch (event->code) {
+      case KeyCode::Text:
+        insert_text(event->text);
+        break;
+      case KeyCode::Paste:
+        insert_text(pasted_text_for_line(event->text));
+        break;
+      case KeyCode::Enter:
+        return finalize_line();
+      case KeyCode::Backspace:
+        erase_before_cursor();
+        break;
+      case KeyCode::Delete:
+        erase_at_cursor();
+        break;
+      case KeyCode::Tab:
+        handled = complete();
+        break;
+      case KeyCode::Up:
+        handled = move_history_up();
+        break;
+      case KeyCode::Down:
+        handled = move_history_down() || move_menu(1);
+        break;
+      case KeyCode::Left:
+        handled = move_cursor(buffer.move_left());
+        break;
+      case KeyCode::Right:
+        handled = move_right();
+        break;
+      case KeyCode::Home:
+        buffer.move_home();
+        dirty = true;
+        break;
+      case KeyCode::End:
+        buffer.move_end();
+        dirty = true;
+        break;
+      case KeyCode::Control:
+        if (event->control == 'd' && buffer.empty()) {
+          renderer_.commit(prompt, buffer.text());
+          return std::nullopt;
         }
-        continue;
+        if (event->control == 'd') {
+          erase_at_cursor();
+        } else if (event->control == 'a') {
+          buffer.move_home();
+          dirty = true;
+        } else if (event->control == 'e') {
+          buffer.move_end();
+          dirty = true;
+        } else if (event->control == 'r') {
+          handled = search_older();
+        }
+        break;
+      default:
+        break;
       }
 
-      continue;
+      if (!handled) {
+        ring_bell(console_);
+      }
     }
 
-    if (std::isprint(static_cast<unsigned char>(key)) != 0) {
-      buffer.push_back(key);
-      history_index = history_.size();
-      draft_buffer = buffer;
+    if (dirty) {
       redraw_with_suggestions();
+      dirty = false;
+      if (keys_read_at != InputMetrics::Clock::time_point{}) {
+        metrics_.record_since(InputStage::KeyToPaint, keys_read_at);
+      }
+    }
+    keys_read_at = {};
+
+    if (decoder_.escape_pending() && !input_ready_within(kEscapeTimeoutMilliseconds)) {
+      // A lone Escape ends reverse search or closes the completion menu.
+      static_cast<void>(decoder_.take_escape());
+      if (searching) {
+        leave_search(true);
+      }
+      close_menu();
+      continue;
+    }
+
+    const Wakeup wakeup =
+        wait_for_input(console_, completion_worker_.wakeup(), renderer_.columns());
+    if (wakeup == Wakeup::Posted) {
+      print_posted();
+      continue;
+    }
+    if (wakeup == Wakeup::Completion) {
+      receive_completion();
+      continue;
+    }
+    if (wakeup == Wakeup::Resize) {
+      resize();
+      continue;
+    }
+
+    const ssize_t count = read(STDIN_FILENO, chunk.data(), chunk.size());
+    if (count < 0 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return std::nullopt;
     }
+    keys_read_at = InputMetrics::now();
+    decoder_.feed(std::string_view{chunk.data(), static_cast<std::size_t>(count)});
   }
 #endif
 }
@@ -0,0 +1,161 @@
+#include "opentui/output_buffer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <utility>
+
+#include "opentui/async_writer.hpp"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace opentui {
+
+OutputBuffer::OutputBuffer(const int file_descriptor, const std::size_t high_watermark)
+    : file_descriptor_(file_descriptor),
+      high_watermark_(std::max<std::size_t>(high_watermark, 1U)) {
+  buffer_.reserve(high_watermark_);
+}
+
+OutputBuffer::~OutputBuffer() {
+  flush();
+}
+
+void OutputBuffer::append(std::string_view text) {
+  if (async_writer_ != nullptr) {
+    buffer_.append(text);
+    if (buffer_.size() >= high_watermark_) {
+      hand_off();
+    }
+    return;
+  }
+
+  if (buffer_.size() + text.size() < high_watermark_) {
+    buffer_.append(text);
+    return;
+  }
+
+  write_segments(buffer_, text);
+  buffer_.clear();
+}
+
+void OutputBuffer::append(const char character) {
+  buffer_.push_back(character);
+  if (buffer_.size() >= high_watermark_) {
+    flush();
+  }
+}
+
+void OutputBuffer::flush() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  if (async_writer_ != nullptr) {
+    hand_off();
+    return;
+  }
+
+  write_segments(buffer_);
+  buffer_.clear();
+}
+
+void OutputBuffer::set_high_watermark(const std::size_t bytes) noexcept {
+  high_watermark_ = std::max<std::size_t>(bytes, 1U);
+}
+
+std::size_t OutputBuffer::high_watermark() const noexcept {
+  return high_watermark_;
+}
+
+void OutputBuffer::set_async_writer(AsyncWriter* writer) {
+  flush();
+  if (async_writer_ != nullptr) {
+    async_writer_->wait_idle();
+    stats_.bytes_written += async_writer_->bytes_written();
+    stats_.bytes_dropped += async_writer_->bytes_dropped();
+  }
+  async_writer_ = writer;
+}
+
+std::string_view OutputBuffer::pending() const noexcept {
+  return buffer_;
+}
+
+const OutputStats& OutputBuffer::stats() const noexcept {
+  return stats_;
+}
+
+void OutputBuffer::hand_off() {
+  ++stats_.flushes;
+  stats_.bytes_handed_off += buffer_.size();
+  async_writer_->submit(std::exchange(buffer_, async_writer_->acquire_buffer()));
+}
+
+void OutputBuffer::write_segments(std::string_view first, std::string_view second) {
+  if (first.empty()) {
+    first = second;
+    second = {};
+  }
+  if (first.empty()) {
+    return;
+  }
+
+  ++stats_.flushes;
+
+#if defined(_WIN32)
+  for (std::string_view segment : {first, second}) {
+    while (!segment.empty()) {
+      ++stats_.write_calls;
+      const int written =
+          _write(file_descriptor_, segment.data(), static_cast<unsigned int>(segment.size()));
+      if (written <= 0) {
+        return;
+      }
+      stats_.bytes_written += static_cast<std::uint64_t>(written);
+      segment.remove_prefix(static_cast<std::size_t>(written));
+    }
+  }
+#else
+  while (!first.empty()) {
+    ssize_t written = 0;
+    ++stats_.write_calls;
+    if (second.empty()) {
+      written = write(file_descriptor_, first.data(), first.size());
+    } else {
+      const std::array<iovec, 2> segments{{
+          {.iov_base = const_cast<char*>(first.data()), .iov_len = first.size()},
+          {.iov_base = const_cast<char*>(second.data()), .iov_len = second.size()},
+      }};
+      written = writev(file_descriptor_, segments.data(), static_cast<int>(segments.size()));
+    }
+
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+
+    auto remaining = static_cast<std::size_t>(written);
+    stats_.bytes_written += remaining;
+
+    const std::size_t from_first = std::min(remaining, first.size());
+    first.remove_prefix(from_first);
+    remaining -= from_first;
+    second.remove_prefix(std::min(remaining, second.size()));
+
+    if (first.empty()) {
+      first = second;
+      second = {};
+    }
+  }
+#endif
+}
+
+} // namespace opentui
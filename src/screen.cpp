@@ -0,0 +1,314 @@
+#include "opentui/screen.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "opentui/ansi.hpp"
+#include "opentui/console.hpp"
+#include "opentui/display_width.hpp"
+
+namespace opentui {
+namespace {
+
+[[nodiscard]] std::size_t encoded_length(const char32_t codepoint) {
+  if (codepoint < 0x80U) {
+    return 1U;
+  }
+  if (codepoint < 0x800U) {
+    return 2U;
+  }
+  if (codepoint < 0x10000U) {
+    return 3U;
+  }
+  return 4U;
+}
+
+void append_utf8(std::string& output, const char32_t codepoint) {
+  switch (encoded_length(codepoint)) {
+  case 1U:
+    output.push_back(static_cast<char>(codepoint));
+    break;
+  case 2U:
+    output.push_back(static_cast<char>(0xC0U | (codepoint >> 6U)));
+    output.push_back(static_cast<char>(0x80U | (codepoint & 0x3FU)));
+    break;
+  case 3U:
+    output.push_back(static_cast<char>(0xE0U | (codepoint >> 12U)));
+    output.push_back(static_cast<char>(0x80U | ((codepoint >> 6U) & 0x3FU)));
+    output.push_back(static_cast<char>(0x80U | (codepoint & 0x3FU)));
+    break;
+  default:
+    output.push_back(static_cast<char>(0xF0U | (codepoint >> 18U)));
+    output.push_back(static_cast<char>(0x80U | ((codepoint >> 12U) & 0x3FU)));
+    output.push_back(static_cast<char>(0x80U | ((codepoint >> 6U) & 0x3FU)));
+    output.push_back(static_cast<char>(0x80U | (codepoint & 0x3FU)));
+    break;
+  }
+}
+
+} // namespace
+
+Screen::Screen(const std::size_t width, const std::size_t height) : width_(0), height_(0) {
+  resize(width, height);
+}
+
+void Screen::resize(const std::size_t width, const std::size_t height) {
+  width_ = width;
+  height_ = height;
+  front_.assign(width_ * height_, Cell{});
+  back_.assign(width_ * height_, Cell{});
+  invalidate();
+}
+
+std::size_t Screen::width() const noexcept {
+  return width_;
+}
+
+std::size_t Screen::height() const noexcept {
+  return height_;
+}
+
+void Screen::clear(const Style style) {
+  std::ranges::fill(back_, Cell{.glyph = U' ', .style = style, .width = 1});
+}
+
+void Screen::put(const std::size_t column, const std::size_t row, const char32_t glyph,
+                 const Style style) {
+  if (column >= width_ || row >= height_) {
+    return;
+  }
+
+  const bool wide = codepoint_width(glyph) == 2U;
+  if (wide && column + 1U >= width_) {
+    put(column, row, U' ', style);
+    return;
+  }
+
+  release_cell(column, row);
+  if (wide) {
+    release_cell(column + 1U, row);
+    back_[offset(column + 1U, row)] = Cell{.glyph = U' ', .style = style, .width = 0};
+  }
+
+  back_[offset(column, row)] =
+      Cell{.glyph = glyph, .style = style, .width = static_cast<std::uint8_t>(wide ? 2U : 1U)};
+}
+
+std::size_t Screen::draw_text(const std::size_t column, const std::size_t row,
+                              std::string_view text, const Style style) {
+  if (row >= height_) {
+    return 0U;
+  }
+
+  std::size_t current = column;
+  std::size_t index = 0;
+  while (index < text.size() && current < width_) {
+    const DecodedCodepoint decoded = decode_utf8(text, index);
+    index += decoded.length;
+
+    // A cell holds a single codepoint, so combining marks and controls are dropped.
+    const std::size_t glyph_width = codepoint_width(decoded.codepoint);
+    if (glyph_width == 0U) {
+      continue;
+    }
+
+    put(current, row, decoded.codepoint, style);
+    current += glyph_width;
+  }
+
+  return current - std::min(column, current);
+}
+
+void Screen::fill(const std::size_t column, const std::size_t row, const std::size_t width,
+                  const std::size_t height, const char32_t glyph, const Style style) {
+  const std::size_t last_row = std::min(height_, row + height);
+  const std::size_t last_column = std::min(width_, column + width);
+  for (std::size_t current_row = row; current_row < last_row; ++current_row) {
+    for (std::size_t current_column = column; current_column < last_column; ++current_column) {
+      put(current_column, current_row, glyph, style);
+    }
+  }
+}
+
+const Cell& Screen::at(const std::size_t column, const std::size_t row) const {
+  if (column >= width_ || row >= height_) {
+    throw std::out_of_range("Screen::at");
+  }
+  return back_[offset(column, row)];
+}
+
+void Screen::invalidate() noexcept {
+  full_repaint_ = true;
+  cursor_known_ = false;
+}
+
+void Screen::present(Console& console) {
+  frame_.clear();
+  // Other console output may have moved the cursor since the previous frame.
+  cursor_known_ = false;
+
+  for (std::size_t row = 0; row < height_; ++row) {
+    for (std::size_t column = 0; column < width_; ++column) {
+      const Cell& cell = back_[offset(column, row)];
+      if (cell.width == 0U || (!full_repaint_ && cell == front_[offset(column, row)])) {
+        continue;
+      }
+
+      move_cursor(column, row);
+      set_style(cell.style);
+      emit_cell(cell);
+    }
+  }
+
+  if (!current_style_.plain()) {
+    set_style(Style{});
+  }
+
+  front_ = back_;
+  full_repaint_ = false;
+
+  if (!frame_.empty()) {
+    console.emit(frame_);
+    console.flush();
+  }
+}
+
+std::size_t Screen::last_frame_bytes() const noexcept {
+  return frame_.size();
+}
+
+std::size_t Screen::offset(const std::size_t column, const std::size_t row) const noexcept {
+  return (row * width_) + column;
+}
+
+void Screen::release_cell(const std::size_t column, const std::size_t row) {
+  // Overwriting either half of a wide glyph turns the other half into a blank.
+  Cell& cell = back_[offset(column, row)];
+  if (cell.width == 0U && column > 0U) {
+    Cell& leader = back_[offset(column - 1U, row)];
+    leader = Cell{.glyph = U' ', .style = leader.style, .width = 1};
+  } else if (cell.width == 2U && column + 1U < width_) {
+    Cell& trailer = back_[offset(column + 1U, row)];
+    trailer = Cell{.glyph = U' ', .style = trailer.style, .width = 1};
+  }
+}
+
+void Screen::move_cursor(const std::size_t column, const std::size_t row) {
+  if (cursor_known_ && cursor_row_ == row && cursor_column_ == column) {
+    return;
+  }
+
+  const std::size_t absolute_cost = ansi::absolute_move_length(row, column);
+
+  // Rewriting unchanged cells in the current style is often cheaper than a cursor sequence.
+  const auto overwrite_cost = [this](const std::size_t from, const std::size_t to,
+                                     const std::size_t on_row) {
+    std::size_t cost = 0;
+    for (std::size_t current = from; current < to; ++current) {
+      const Cell& cell = back_[offset(current, on_row)];
+      if (cell.width != 1U || cell.style != current_style_ ||
+          cell != front_[offset(current, on_row)]) {
+        return std::numeric_limits<std::size_t>::max();
+      }
+      cost += encoded_length(cell.glyph);
+    }
+    return cost;
+  };
+
+  const auto horizontal_cost = [&](const std::size_t from, const std::size_t to,
+                                   const std::size_t on_row) {
+    const std::size_t move = ansi::horizontal_move_length(from, to);
+    return to > from ? std::min(move, overwrite_cost(from, to, on_row)) : move;
+  };
+
+  const auto emit_horizontal = [&](const std::size_t from, const std::size_t to,
+                                   const std::size_t on_row) {
+    if (to > from && overwrite_cost(from, to, on_row) <= ansi::horizontal_move_length(from, to)) {
+      for (std::size_t current = from; current < to; ++current) {
+        append_utf8(frame_, back_[offset(current, on_row)].glyph);
+      }
+      return;
+    }
+    ansi::append_horizontal_move(frame_, from, to);
+  };
+
+  enum class Plan { Absolute, Horizontal, Vertical, NextLine };
+  Plan plan = Plan::Absolute;
+  std::size_t best = absolute_cost;
+
+  if (cursor_known_) {
+    if (cursor_row_ == row) {
+      const std::size_t cost = horizontal_cost(cursor_column_, column, row);
+      if (cost < best) {
+        best = cost;
+        plan = Plan::Horizontal;
+      }
+    } else {
+      const std::size_t vertical =
+          ansi::cursor_sequence_length(row > cursor_row_ ? row - cursor_row_ : cursor_row_ - row);
+      const std::size_t cost = vertical + horizontal_cost(cursor_column_, column, row);
+      if (cost < best) {
+        best = cost;
+        plan = Plan::Vertical;
+      }
+      if (row == cursor_row_ + 1U) {
+        const std::size_t next_line = 2U + horizontal_cost(0U, column, row);
+        if (next_line < best) {
+          best = next_line;
+          plan = Plan::NextLine;
+        }
+      }
+    }
+  }
+
+  switch (plan) {
+  case Plan::Absolute:
+    ansi::append_absolute_move(frame_, row, column);
+    break;
+  case Plan::Horizontal:
+    emit_horizontal(cursor_column_, column, row);
+    break;
+  case Plan::Vertical:
+    if (row > cursor_row_) {
+      ansi::append_cursor_sequence(frame_, row - cursor_row_, 'B');
+    } else {
+      ansi::append_cursor_sequence(frame_, cursor_row_ - row, 'A');
+    }
+    emit_horizontal(cursor_column_, column, row);
+    break;
+  case Plan::NextLine:
+    frame_.append("\r\n");
+    emit_horizontal(0U, column, row);
+    break;
+  }
+
+  cursor_known_ = true;
+  cursor_column_ = column;
+  cursor_row_ = row;
+}
+
+void Screen::set_style(const Style style) {
+  if (style == current_style_) {
+    return;
+  }
+
+  if (!current_style_.plain()) {
+    frame_.append(Style::reset());
+  }
+  frame_.append(style.prefix());
+  current_style_ = style;
+}
+
+void Screen::emit_cell(const Cell& cell) {
+  append_utf8(frame_, cell.glyph);
+  cursor_column_ += std::max<std::size_t>(cell.width, 1U);
+
+  // Writing the last column leaves the terminal in a pending-wrap state whose cursor position
+  // differs between emulators, so the next move is made absolute.
+  if (cursor_column_ >= width_) {
+    cursor_known_ = false;
+  }
+}
+
+} // namespace opentui
@@ -0,0 +1,147 @@
+#include "opentui/scrollback.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "opentui/text_search.hpp"
+
+namespace opentui {
+
+Scrollback::Scrollback(const std::size_t memory_limit)
+    : memory_limit_(std::max(memory_limit, kChunkSize)) {}
+
+void Scrollback::append(std::string_view text) {
+  while (!text.empty()) {
+    const std::size_t newline = text.find('\n');
+    if (newline == std::string_view::npos) {
+      partial_.append(text);
+      return;
+    }
+
+    if (partial_.empty()) {
+      store_line(text.substr(0, newline));
+    } else {
+      partial_.append(text.substr(0, newline));
+      store_line(partial_);
+      partial_.clear();
+    }
+    text.remove_prefix(newline + 1U);
+  }
+}
+
+void Scrollback::append_line(std::string_view line) {
+  append(line);
+  append(std::string_view{"\n"});
+}
+
+void Scrollback::clear() {
+  chunks_.clear();
+  partial_.clear();
+  memory_usage_ = 0;
+}
+
+std::uint64_t Scrollback::first_line_number() const noexcept {
+  return chunks_.empty() ? next_line_ : chunks_.front().first_line;
+}
+
+std::uint64_t Scrollback::end_line_number() const noexcept {
+  return next_line_;
+}
+
+std::size_t Scrollback::size() const noexcept {
+  return static_cast<std::size_t>(next_line_ - first_line_number());
+}
+
+std::size_t Scrollback::memory_usage() const noexcept {
+  return memory_usage_;
+}
+
+std::size_t Scrollback::memory_limit() const noexcept {
+  return memory_limit_;
+}
+
+std::string_view Scrollback::line(const std::uint64_t line_number) const {
+  if (line_number < first_line_number() || line_number >= next_line_) {
+    return {};
+  }
+
+  const auto chunk = std::ranges::upper_bound(chunks_, line_number, {}, &Chunk::first_line);
+  const Chunk& owner = *std::prev(chunk);
+  return line_in(owner, static_cast<std::size_t>(line_number - owner.first_line));
+}
+
+std::vector<ScrollbackMatch> Scrollback::find(std::string_view needle,
+                                              const std::size_t limit) const {
+  std::vector<ScrollbackMatch> matches;
+  if (needle.empty() || limit == 0U || needle.find('\n') != std::string_view::npos) {
+    return matches;
+  }
+
+  std::vector<std::size_t> chunk_hits;
+  for (auto chunk = chunks_.rbegin(); chunk != chunks_.rend() && matches.size() < limit; ++chunk) {
+    // Lines are newline-separated inside the chunk, so a single scan covers all of them.
+    const std::string_view haystack{chunk->data.data(), chunk->used};
+    chunk_hits.clear();
+
+    std::size_t position = find_substring(haystack, needle);
+    while (position != std::string_view::npos) {
+      const auto line_end = std::ranges::lower_bound(chunk->line_ends, position + needle.size());
+      const auto index = static_cast<std::size_t>(line_end - chunk->line_ends.begin());
+      chunk_hits.push_back(index);
+
+      // Resume after this line so each line is reported once.
+      position = find_substring(haystack, needle, static_cast<std::size_t>(*line_end) + 1U);
+    }
+
+    for (auto hit = chunk_hits.rbegin(); hit != chunk_hits.rend() && matches.size() < limit;
+         ++hit) {
+      matches.push_back(ScrollbackMatch{.line_number = chunk->first_line + *hit,
+                                        .text = line_in(*chunk, *hit)});
+    }
+  }
+
+  return matches;
+}
+
+Scrollback::Chunk& Scrollback::chunk_for(const std::size_t bytes) {
+  if (!chunks_.empty()) {
+    Chunk& tail = chunks_.back();
+    if (tail.data.size() - tail.used >= bytes) {
+      return tail;
+    }
+  }
+
+  const std::size_t capacity = std::max(kChunkSize, bytes);
+  Chunk& chunk = chunks_.emplace_back();
+  chunk.data.resize(capacity);
+  chunk.first_line = next_line_;
+  memory_usage_ += capacity;
+  enforce_limit();
+  return chunks_.back();
+}
+
+std::string_view Scrollback::line_in(const Chunk& chunk, const std::size_t index) const {
+  const std::size_t begin = index == 0U ? 0U : chunk.line_ends[index - 1U] + 1U;
+  return {chunk.data.data() + begin, chunk.line_ends[index] - begin};
+}
+
+void Scrollback::store_line(std::string_view line) {
+  Chunk& chunk = chunk_for(line.size() + 1U);
+  std::memcpy(chunk.data.data() + chunk.used, line.data(), line.size());
+  chunk.used += line.size();
+  chunk.line_ends.push_back(static_cast<std::uint32_t>(chunk.used));
+  chunk.data[chunk.used++] = '\n';
+  memory_usage_ += sizeof(std::uint32_t);
+  ++next_line_;
+}
+
+void Scrollback::enforce_limit() {
+  while (chunks_.size() > 1U && memory_usage_ > memory_limit_) {
+    const Chunk& oldest = chunks_.front();
+    memory_usage_ -= oldest.data.size() + (oldest.line_ends.size() * sizeof(std::uint32_t));
+    chunks_.pop_front();
+  }
+}
+
+} // namespace opentui
@@ -34,6 +34,10 @@ void SignalManager::clear_stop() noexcept {
   stop_requested_.store(false);
 }
 
+bool SignalManager::take_stop() noexcept {
+  return stop_requested_.exchange(false);
+}
+
 void SignalManager::on_signal(const int signal) noexcept {
   static_cast<void>(signal);
   request_stop();
@@ -0,0 +1,115 @@
+#include "opentui/style.hpp"
+
+#include <array>
+
+namespace opentui {
+namespace {
+
+struct SgrSequence {
+  std::array<char, 16> bytes{};
+  std::size_t size{0};
+
+  constexpr void push(const char character) {
+    bytes[size++] = character;
+  }
+
+  constexpr void push_code(const int code) {
+    if (code >= 100) {
+      push(static_cast<char>('0' + (code / 100)));
+    }
+    if (code >= 10) {
+      push(static_cast<char>('0' + ((code / 10) % 10)));
+    }
+    push(static_cast<char>('0' + (code % 10)));
+  }
+};
+
+[[nodiscard]] constexpr int ansi_foreground(const Color color) {
+  const int value = static_cast<int>(color);
+  if (value < 0) {
+    return -1;
+  }
+  if (value <= 7) {
+    return 30 + value;
+  }
+  if (value <= 15) {
+    return 90 + (value - 8);
+  }
+  return -1;
+}
+
+[[nodiscard]] constexpr int ansi_background(const Color color) {
+  const int value = static_cast<int>(color);
+  if (value < 0) {
+    return -1;
+  }
+  if (value <= 7) {
+    return 40 + value;
+  }
+  if (value <= 15) {
+    return 100 + (value - 8);
+  }
+  return -1;
+}
+
+[[nodiscard]] constexpr SgrSequence build_sgr_sequence(const Style style) {
+  SgrSequence sequence;
+  if (style.plain()) {
+    return sequence;
+  }
+
+  sequence.push('\033');
+  sequence.push('[');
+
+  bool first = true;
+  const auto push_parameter = [&sequence, &first](const int code) {
+    if (code < 0) {
+      return;
+    }
+    if (!first) {
+      sequence.push(';');
+    }
+    sequence.push_code(code);
+    first = false;
+  };
+
+  push_parameter(style.bold() ? 1 : -1);
+  push_parameter(ansi_foreground(style.foreground()));
+  push_parameter(ansi_background(style.background()));
+  sequence.push('m');
+  return sequence;
+}
+
+[[nodiscard]] constexpr std::array<SgrSequence, Style::kCount> build_sgr_table() {
+  std::array<SgrSequence, Style::kCount> table{};
+
+  for (const bool bold : {false, true}) {
+    for (int foreground = -1; foreground < 16; ++foreground) {
+      for (int background = -1; background < 16; ++background) {
+        const Style style{static_cast<Color>(foreground), static_cast<Color>(background), bold};
+        table[style.index()] = build_sgr_sequence(style);
+      }
+    }
+  }
+
+  return table;
+}
+
+constexpr std::array<SgrSequence, Style::kCount> kSgrTable = build_sgr_table();
+
+[[nodiscard]] constexpr std::string_view sgr_for(const Style style) {
+  const SgrSequence& sequence = kSgrTable[style.index()];
+  return {sequence.bytes.data(), sequence.size};
+}
+
+static_assert(sgr_for(Style{}).empty());
+static_assert(sgr_for(Style{Color::Red}) == "\033[31m");
+static_assert(sgr_for(Style{Color::BrightWhite, Color::BrightBlack, true}) == "\033[1;97;100m");
+
+} // namespace
+
+std::string_view Style::prefix() const noexcept {
+  return sgr_for(*this);
+}
+
+} // namespace opentui
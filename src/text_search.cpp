@@ -0,0 +1,57 @@
+#include "opentui/text_search.hpp"
+
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define OPEN_TUI_HAS_SSE2 1
+#endif
+
+namespace opentui {
+
+std::size_t find_substring(std::string_view haystack, std::string_view needle,
+                           std::size_t from) noexcept {
+  if (needle.empty()) {
+    return from <= haystack.size() ? from : std::string_view::npos;
+  }
+  if (from >= haystack.size() || haystack.size() - from < needle.size()) {
+    return std::string_view::npos;
+  }
+
+#if defined(OPEN_TUI_HAS_SSE2)
+  constexpr std::size_t kLanes = 16;
+  const std::size_t last_offset = needle.size() - 1U;
+  const __m128i first = _mm_set1_epi8(needle.front());
+  const __m128i last = _mm_set1_epi8(needle.back());
+
+  std::size_t position = from;
+  while (position + last_offset + kLanes <= haystack.size()) {
+    const __m128i block_first =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack.data() + position));
+    const __m128i block_last =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack.data() + position + last_offset));
+
+    auto mask = static_cast<unsigned int>(_mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last))));
+
+    while (mask != 0U) {
+      const auto lane = static_cast<std::size_t>(std::countr_zero(mask));
+      const char* candidate = haystack.data() + position + lane;
+      if (needle.size() <= 2U ||
+          std::memcmp(candidate + 1, needle.data() + 1, needle.size() - 2U) == 0) {
+        return position + lane;
+      }
+      mask &= mask - 1U;
+    }
+
+    position += kLanes;
+  }
+
+  return haystack.find(needle, position);
+#else
+  return haystack.find(needle, from);
+#endif
+}
+
+} // namespace opentui
@@ -1,20 +1,82 @@
 #include "opentui/tui_application.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <string>
 #include <string_view>
 #include <utility>
 
+#include "opentui/input_metrics.hpp"
 #include "opentui/signal_manager.hpp"
 
 namespace opentui {
 
 namespace {
 
-std::vector<std::string> no_completion(std::string_view partial, const Args& args) {
+std::vector<std::string> no_completion(std::string_view partial, const ArgsView args) {
   static_cast<void>(partial);
   static_cast<void>(args);
   return {};
 }
 
+[[nodiscard]] std::optional<std::size_t> parse_job_id(const std::string_view text) {
+  std::size_t id = 0;
+  const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), id);
+  if (error != std::errc{} || end != text.data() + text.size()) {
+    return std::nullopt;
+  }
+  return id;
+}
+
+constexpr CommandTable kBuiltinCommands{std::array{
+    CommandSpec{
+        .name = "help",
+        .description = "Show all available commands.",
+        .aliases = {"/help"},
+    },
+    CommandSpec{
+        .name = "clear",
+        .description = "Clear the screen.",
+        .aliases = {"/clear"},
+    },
+    CommandSpec{
+        .name = "/find",
+        .description = "Search the scrollback. Usage: /find <text>",
+    },
+    CommandSpec{
+        .name = "/perf",
+        .description =
+            "Show keystroke latency by stage. Usage: /perf input [reset | export <file>]",
+        .narrowable = true,
+    },
+    CommandSpec{
+        .name = "jobs",
+        .description = "List background jobs.",
+        .aliases = {"/jobs"},
+    },
+    CommandSpec{
+        .name = "fg",
+        .description = "Wait for a background job; Ctrl-C cancels it. Usage: fg [id]",
+        .aliases = {"/fg"},
+    },
+    CommandSpec{
+        .name = "kill",
+        .description = "Cancel a background job. Usage: kill <id>",
+        .aliases = {"/kill"},
+    },
+    CommandSpec{
+        .name = "exit",
+        .description = "Exit the debugger interface.",
+        .aliases = {"quit", "/exit", "/quit"},
+    },
+}};
+
+static_assert(kBuiltinCommands.find("/quit") == kBuiltinCommands.find("exit"));
+static_assert(!kBuiltinCommands.find("/exi").has_value());
+
 } // namespace
 
 std::string TuiApplication::banner() const {
@@ -25,6 +87,10 @@ std::string TuiApplication::prompt() const {
   return "tui> ";
 }
 
+std::filesystem::path TuiApplication::history_file() const {
+  return {};
+}
+
 void TuiApplication::on_start(Console& console) {
   static_cast<void>(console);
 }
@@ -38,22 +104,31 @@ Console& TuiApplication::console() noexcept {
 }
 
 int TuiApplication::run() {
-  command_registry_ = CommandRegistry{};
-  running_.store(true);
-
   SignalManager signal_manager;
-  register_builtin_commands();
-  register_commands(command_registry_);
+  if (console_.scrollback() == nullptr) {
+    console_.enable_scrollback();
+  }
+  reset_commands();
+
+  if (const std::filesystem::path path = history_file();
+      !path.empty() && !line_editor_.history().has_file() && !line_editor_.set_history_file(path)) {
+    console_.println_color("Could not open history file: " + path.string(), Color::BrightYellow);
+  }
 
   console_.println_color(banner(), Color::BrightCyan, Color::Default, true);
   on_start(console_);
 
-  CommandContext context{.console = console_, .running = running_};
+  CommandContext context{.console = console_, .running = running_, .jobs = &jobs_};
 
   while (running_.load() && !signal_manager.stop_requested()) {
-    const auto line = line_editor_.read_line(prompt(), [this](const std::string_view input_buffer) {
-      return command_registry_.complete(input_buffer);
-    });
+    // Handlers may change what completers return, so each prompt starts with an empty cache.
+    completion_cache_.clear();
+    const auto line = line_editor_.read_line(
+        prompt(), [this](const std::string_view input_buffer, const std::size_t offset,
+                         const std::size_t count, const std::stop_token& stop_token) {
+          return command_registry_.complete_page(input_buffer, offset, count, completion_cache_,
+                                                 stop_token);
+        });
 
     if (!line.has_value()) {
       break;
@@ -66,91 +141,233 @@ int TuiApplication::run() {
     console_.println_color("Termination signal received. Exiting...", Color::BrightYellow);
   }
 
+  // Jobs may still be using state that subclasses own, so they are stopped before it goes away.
+  jobs_.stop_all();
+  console_.drain_posted();
   on_shutdown(console_);
   return 0;
 }
 
-void TuiApplication::register_builtin_commands() {
-  const auto register_builtin = [this](Command command) {
-    const std::string command_name = command.name;
-    if (!command_registry_.add(std::move(command))) {
-      console_.println_color("Failed to register builtin command: " + command_name,
-                             Color::BrightRed);
+int TuiApplication::run(const int argc, const char* const* argv) {
+  ScriptOptions options;
+  bool batch = false;
+  for (int index = 1; index < argc; ++index) {
+    const std::string_view argument = argv[index];
+    if (argument == "--batch") {
+      batch = true;
+    } else if (argument == "--stop-on-error") {
+      options.stop_on_error = true;
+    } else {
+      std::cerr << "Unknown option: " << argument << "\nUsage: " << argv[0]
+                << " [--batch [--stop-on-error]]\n";
+      return 2;
     }
-  };
+  }
+  return batch ? run_script(std::cin, options) : run();
+}
+
+int TuiApplication::run_script(std::istream& input, const ScriptOptions& options) {
+  reset_commands();
+
+  CommandContext context{.console = console_, .running = running_};
+  const ScriptResult result = command_registry_.run_script(input, context, options);
+  if (result.failed == 0U) {
+    return 0;
+  }
+
+  constexpr std::size_t kMaxListedLines = 10;
+  std::cerr << result.failed << " of " << result.commands << " commands failed (line";
+  std::cerr << (result.failed == 1U ? " " : "s ");
+  for (std::size_t index = 0; index < std::min(result.failed, kMaxListedLines); ++index) {
+    std::cerr << (index == 0U ? "" : ", ") << result.failed_lines[index];
+  }
+  std::cerr << (result.failed > kMaxListedLines ? ", ...)\n" : ")\n");
+  return 1;
+}
+
+void TuiApplication::reset_commands() {
+  command_registry_ = CommandRegistry{};
+  running_.store(true);
+  register_builtin_commands();
+  register_commands(command_registry_);
+}
 
-  const auto help_handler = [this](const Args& args, CommandContext& context) {
+void TuiApplication::register_builtin_commands() {
+  const auto help_handler = [this](const ArgsView args, CommandContext& context) {
     static_cast<void>(args);
     static_cast<void>(context);
     console_.println(command_registry_.help_text());
   };
 
-  register_builtin(Command{
-      .name = "help",
-      .description = "Show all available commands.",
-      .handler = help_handler,
-      .completer = no_completion,
-  });
-
-  register_builtin(Command{
-      .name = "/help",
-      .description = "Slash alias for help.",
-      .handler = help_handler,
-      .completer = no_completion,
-  });
-
-  const auto clear_handler = [this](const Args& args, CommandContext& context) {
+  const auto clear_handler = [this](const ArgsView args, CommandContext& context) {
     static_cast<void>(args);
     static_cast<void>(context);
     console_.clear_screen();
   };
 
-  register_builtin(Command{
-      .name = "clear",
-      .description = "Clear the screen.",
-      .handler = clear_handler,
-      .completer = no_completion,
-  });
-
-  register_builtin(Command{
-      .name = "/clear",
-      .description = "Slash alias for clear.",
-      .handler = clear_handler,
-      .completer = no_completion,
-  });
-
-  const auto exit_handler = [](const Args& args, CommandContext& context) {
+  const auto find_handler = [this](const ArgsView args, CommandContext& context) {
+    const Scrollback* scrollback = console_.scrollback();
+    if (scrollback == nullptr) {
+      console_.println_color("Scrollback is disabled.", Color::BrightYellow);
+      return;
+    }
+
+    if (args.empty()) {
+      console_.println_color("Usage: /find <text>", Color::BrightRed);
+      context.failed = true;
+      return;
+    }
+
+    std::string needle{args.front()};
+    for (std::size_t index = 1; index < args.size(); ++index) {
+      needle += ' ';
+      needle += args[index];
+    }
+
+    constexpr std::size_t kMaxShownMatches = 20;
+    const auto matches = scrollback->find(needle, kMaxShownMatches);
+    if (matches.empty()) {
+      console_.println_color("No matches in " + std::to_string(scrollback->size()) +
+                                 " scrollback lines.",
+                             Color::BrightBlack);
+      return;
+    }
+
+    // Results are emitted rather than printed so repeated searches do not match their own output.
+    std::string results;
+    for (auto match = matches.rbegin(); match != matches.rend(); ++match) {
+      console_.paint_to(results, "  #" + std::to_string(match->line_number) + "  ",
+                        Color::BrightBlack);
+      results.append(match->text);
+      results.push_back('\n');
+    }
+    console_.paint_to(results, std::to_string(matches.size()) + " most recent matches shown.",
+                      Color::BrightBlack);
+    results.push_back('\n');
+    console_.emit(results);
+  };
+
+  const auto perf_handler = [this](const ArgsView args, CommandContext& context) {
+    const auto print_usage = [this, &context]() {
+      console_.println_color("Usage: /perf input [reset | export <file>]", Color::BrightRed);
+      context.failed = true;
+    };
+    if (args.empty() || args.front() != "input") {
+      print_usage();
+      return;
+    }
+    if (!kInputMetricsEnabled) {
+      console_.println_color("Input metrics are not compiled in; configure with "
+                             "-DOPEN_TUI_INPUT_METRICS=ON.",
+                             Color::BrightYellow);
+      return;
+    }
+
+    InputMetrics& metrics = line_editor_.input_metrics();
+    if (args.size() == 1U) {
+      console_.println(metrics.report());
+    } else if (args.size() == 2U && args[1] == "reset") {
+      metrics.reset();
+      console_.println_color("Input metrics reset.", Color::BrightBlack);
+    } else if (args.size() == 3U && args[1] == "export") {
+      if (metrics.export_csv(args[2])) {
+        console_.println_color("Input metrics written to " + std::string{args[2]},
+                               Color::BrightBlack);
+      } else {
+        console_.println_color("Could not write " + std::string{args[2]}, Color::BrightRed);
+        context.failed = true;
+      }
+    } else {
+      print_usage();
+    }
+  };
+
+  const auto perf_completer = [](const std::string_view partial, const ArgsView args) {
+    static_cast<void>(partial);
+    constexpr std::array<std::string_view, 1> kTopics{"input"};
+    constexpr std::array<std::string_view, 2> kActions{"reset", "export"};
+    if (args.empty()) {
+      return std::vector<std::string>(kTopics.begin(), kTopics.end());
+    }
+    if (args.size() == 1U && args.front() == "input") {
+      return std::vector<std::string>(kActions.begin(), kActions.end());
+    }
+    return std::vector<std::string>{};
+  };
+
+  const auto jobs_handler = [this](const ArgsView args, CommandContext& context) {
+    static_cast<void>(args);
+    static_cast<void>(context);
+    const std::vector<JobInfo> jobs = jobs_.take_jobs();
+    if (jobs.empty()) {
+      console_.println_color("No jobs.", Color::BrightBlack);
+      return;
+    }
+    for (const JobInfo& job : jobs) {
+      console_.println(job_line(job.id, job_state_name(job.state), job.command));
+    }
+  };
+
+  const auto fg_handler = [this](const ArgsView args, CommandContext& context) {
+    std::optional<std::size_t> id;
+    if (args.empty()) {
+      id = jobs_.latest_running();
+      if (!id) {
+        console_.println_color("No running jobs.", Color::BrightYellow);
+        return;
+      }
+    } else if (args.size() == 1U) {
+      id = parse_job_id(args.front());
+    }
+    if (!id) {
+      console_.println_color("Usage: fg [id]", Color::BrightRed);
+      context.failed = true;
+      return;
+    }
+
+    // Ctrl-C while waiting cancels the job instead of ending the application.
+    const std::optional<JobState> state =
+        jobs_.wait(*id, [] { return SignalManager::take_stop(); });
+    if (!state) {
+      console_.println_color("No job " + std::to_string(*id) + ".", Color::BrightRed);
+      context.failed = true;
+      return;
+    }
+    context.failed = *state == JobState::Failed;
+  };
+
+  const auto kill_handler = [this](const ArgsView args, CommandContext& context) {
+    const std::optional<std::size_t> id =
+        args.size() == 1U ? parse_job_id(args.front()) : std::nullopt;
+    if (!id) {
+      console_.println_color("Usage: kill <id>", Color::BrightRed);
+      context.failed = true;
+      return;
+    }
+    if (!jobs_.cancel(*id)) {
+      console_.println_color("No running job " + std::to_string(*id) + ".", Color::BrightRed);
+      context.failed = true;
+    }
+  };
+
+  const auto exit_handler = [](const ArgsView args, CommandContext& context) {
     static_cast<void>(args);
     context.running.store(false);
   };
 
-  register_builtin(Command{
-      .name = "exit",
-      .description = "Exit the debugger interface.",
-      .handler = exit_handler,
-      .completer = no_completion,
-  });
-
-  register_builtin(Command{
-      .name = "quit",
-      .description = "Alias for exit.",
-      .handler = exit_handler,
-      .completer = no_completion,
-  });
-
-  register_builtin(Command{
-      .name = "/exit",
-      .description = "Slash alias for exit.",
-      .handler = exit_handler,
-      .completer = no_completion,
-  });
-
-  register_builtin(Command{
-      .name = "/quit",
-      .description = "Slash alias for quit.",
-      .handler = exit_handler,
-      .completer = no_completion,
-  });
+  std::vector<CommandBinding> bindings{
+      {.name = "help", .handler = help_handler, .completer = no_completion},
+      {.name = "clear", .handler = clear_handler, .completer = no_completion},
+      {.name = "/find", .handler = find_handler, .completer = no_completion},
+      {.name = "/perf", .handler = perf_handler, .completer = perf_completer},
+      {.name = "jobs", .handler = jobs_handler, .completer = no_completion},
+      {.name = "fg", .handler = fg_handler, .completer = no_completion},
+      {.name = "kill", .handler = kill_handler, .completer = no_completion},
+      {.name = "exit", .handler = exit_handler, .completer = no_completion},
+  };
+  if (!command_registry_.add_table(kBuiltinCommands.view(), std::move(bindings))) {
+    console_.println_color("Failed to register builtin commands.", Color::BrightRed);
+  }
 }
 
 } // namespace opentui
@@ -129,6 +129,13 @@ bool UdpClient::send_to(std::string_view host, const std::uint16_t port, std::st
 std::optional<std::string> UdpClient::receive_once(const std::uint16_t local_port,
                                                    const std::chrono::milliseconds timeout,
                                                    std::string* error) const {
+  return receive_once(local_port, timeout, std::stop_token{}, error);
+}
+
+std::optional<std::string> UdpClient::receive_once(const std::uint16_t local_port,
+                                                   const std::chrono::milliseconds timeout,
+                                                   const std::stop_token stop_token,
+                                                   std::string* error) const {
 #if defined(_WIN32)
   static WinsockRuntime winsock_runtime;
   if (!winsock_runtime.initialized()) {
@@ -154,35 +161,53 @@ std::optional<std::string> UdpClient::receive_once(const std::uint16_t local_por
     return std::nullopt;
   }
 
-#if defined(_WIN32)
-  const DWORD timeout_ms = static_cast<DWORD>(timeout.count());
-  setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout_ms),
-             sizeof(timeout_ms));
-#else
-  timeval timeout_value{};
-  const auto timeout_count = timeout.count();
-  timeout_value.tv_sec = static_cast<long>(timeout_count / 1000);
-  timeout_value.tv_usec = static_cast<suseconds_t>((timeout_count % 1000) * 1000);
-  setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout_value, sizeof(timeout_value));
-#endif
-
+  // A zero timeout waits forever, as SO_RCVTIMEO does. Without a stop token one wait covers the
+  // whole timeout; with one, the wait is sliced so a cancelled receive returns within
+  // kStopPollInterval.
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
   std::array<char, 2048> buffer{};
+  while (!stop_token.stop_requested()) {
+    auto slice = timeout;
+    if (timeout.count() > 0) {
+      slice = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now());
+      if (slice.count() <= 0) {
+        break;
+      }
+    }
+    if (stop_token.stop_possible() && (slice.count() == 0 || slice > kStopPollInterval)) {
+      slice = kStopPollInterval;
+    }
+
 #if defined(_WIN32)
-  const int bytes_received = recvfrom(socket_descriptor, buffer.data(),
-                                      static_cast<int>(buffer.size()), 0, nullptr, nullptr);
+    const DWORD timeout_ms = static_cast<DWORD>(slice.count());
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVTIMEO,
+               reinterpret_cast<const char*>(&timeout_ms), sizeof(timeout_ms));
+    const int bytes_received = recvfrom(socket_descriptor, buffer.data(),
+                                        static_cast<int>(buffer.size()), 0, nullptr, nullptr);
 #else
-  const ssize_t bytes_received =
-      recvfrom(socket_descriptor, buffer.data(), buffer.size(), 0, nullptr, nullptr);
+    timeval timeout_value{};
+    const auto timeout_count = slice.count();
+    timeout_value.tv_sec = static_cast<long>(timeout_count / 1000);
+    timeout_value.tv_usec = static_cast<suseconds_t>((timeout_count % 1000) * 1000);
+    setsockopt(socket_descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout_value, sizeof(timeout_value));
+    const ssize_t bytes_received =
+        recvfrom(socket_descriptor, buffer.data(), buffer.size(), 0, nullptr, nullptr);
 #endif
 
-  close_socket(socket_descriptor);
-
-  if (bytes_received <= 0) {
-    set_error(error, "No UDP message received before timeout.");
-    return std::nullopt;
+    if (bytes_received > 0) {
+      close_socket(socket_descriptor);
+      return std::string(buffer.data(), static_cast<std::size_t>(bytes_received));
+    }
+    if (!stop_token.stop_possible()) {
+      break;
+    }
   }
 
-  return std::string(buffer.data(), static_cast<std::size_t>(bytes_received));
+  close_socket(socket_descriptor);
+  set_error(error, stop_token.stop_requested() ? "UDP wait cancelled."
+                                               : "No UDP message received before timeout.");
+  return std::nullopt;
 }
 
 void UdpClient::set_error(std::string* error, std::string_view message) {
@@ -0,0 +1,72 @@
+#include "opentui/wakeup_signal.hpp"
+
+#if !defined(_WIN32)
+#include <array>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace opentui {
+
+WakeupSignal::WakeupSignal() {
+#if !defined(_WIN32)
+  std::array<int, 2> descriptors{-1, -1};
+  if (pipe(descriptors.data()) != 0) {
+    return;
+  }
+
+  for (const int descriptor : descriptors) {
+    fcntl(descriptor, F_SETFL, fcntl(descriptor, F_GETFL) | O_NONBLOCK);
+    fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+  }
+
+  read_fd_ = descriptors[0];
+  write_fd_ = descriptors[1];
+#endif
+}
+
+WakeupSignal::~WakeupSignal() {
+#if !defined(_WIN32)
+  if (read_fd_ >= 0) {
+    close(read_fd_);
+  }
+  if (write_fd_ >= 0) {
+    close(write_fd_);
+  }
+#endif
+}
+
+void WakeupSignal::notify() noexcept {
+  if (pending_.exchange(true)) {
+    return;
+  }
+
+#if !defined(_WIN32)
+  if (write_fd_ >= 0) {
+    const char token = 1;
+    static_cast<void>(write(write_fd_, &token, 1));
+  }
+#endif
+}
+
+bool WakeupSignal::consume() noexcept {
+#if !defined(_WIN32)
+  if (read_fd_ >= 0) {
+    std::array<char, 64> sink{};
+    while (read(read_fd_, sink.data(), sink.size()) > 0) {
+    }
+  }
+#endif
+  return pending_.exchange(false);
+}
+
+bool WakeupSignal::pending() const noexcept {
+  return pending_.load();
+}
+
+int WakeupSignal::native_handle() const noexcept {
+  return read_fd_;
+}
+
+} // namespace opentui